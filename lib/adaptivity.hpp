@@ -0,0 +1,82 @@
+/**
+ * \file adaptivity.hpp
+ *
+ * Adaptive refinement of the grid driven by an a posteriori error estimator
+ */
+
+#pragma once
+
+#include "solver_options.hpp"
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_refinement.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/error_estimator.h>
+
+#include <iostream>
+#include <limits>
+
+using namespace dealii;
+
+/**
+	 * One estimate-mark-refine step of the adaptive solve. The error of the current solution is estimated cell by cell with the Kelly
+   * estimator, which integrates the jump of the normal derivative over the faces. The cells that together make up the refine fraction
+   * of the total error are refined, the ones that make up the coarsen fraction are coarsened, so the degrees of freedom go where the
+   * solution is hard to resolve, e.g. at the corners of the domain or the inner radius of the shell. The loop stops once the estimated error is below the tolerance of
+   * the solver options, the DoF budget is used up or the maximum number of cycles is reached.
+   *
+   * \param triangulation Triangulation that is refined.
+   * \param dof_handler DoFHandler of the current solution.
+   * \param solution Solution on the current grid.
+   * \param options Solver options with the adaptive refinement settings.
+   * \param cycle Number of refinement cycles done so far.
+   * \return True if the grid has been refined and the problem has to be solved again, false if the adaptive loop is finished
+ 	 *
+	 */
+template <int dim>
+bool refine_grid_adaptively(Triangulation<dim> &triangulation,
+                            const DoFHandler<dim> &dof_handler,
+                            const Vector<double> &solution,
+                            const SolverOptions &options,
+                            const unsigned int cycle)
+{
+  if (!options.adaptive_refinement || cycle >= options.max_adaptive_cycles)
+    return false;
+  if (options.max_dofs > 0 && dof_handler.n_dofs() >= options.max_dofs)
+    return false;
+
+  Vector<float> estimated_error_per_cell(triangulation.n_active_cells());
+  KellyErrorEstimator<dim>::estimate(dof_handler,
+                                     QGauss<dim - 1>(dof_handler.get_fe().degree + 1),
+                                     {},
+                                     solution,
+                                     estimated_error_per_cell);
+  const double estimated_error = estimated_error_per_cell.l2_norm();
+  std::cout << "   Cycle " << cycle << ": estimated error " << estimated_error << std::endl;
+  if (estimated_error <= options.adaptive_tolerance)
+    return false;
+
+  /* The DoF budget is converted into a cell budget with the current number of degrees of freedom per cell, the marking refines
+     fewer cells if the budget would be exceeded */
+  unsigned int max_n_cells = std::numeric_limits<unsigned int>::max();
+  if (options.max_dofs > 0)
+    max_n_cells = static_cast<unsigned int>(static_cast<double>(options.max_dofs) * triangulation.n_active_cells() /
+                                            dof_handler.n_dofs());
+
+  report_progress(options.progress, SolvePhase::grid);
+  GridRefinement::refine_and_coarsen_fixed_fraction(triangulation,
+                                                    estimated_error_per_cell,
+                                                    options.refine_fraction,
+                                                    options.coarsen_fraction,
+                                                    max_n_cells);
+  triangulation.execute_coarsening_and_refinement();
+  std::cout << "   Number of active cells: " << triangulation.n_active_cells()
+            << std::endl;
+  return true;
+}
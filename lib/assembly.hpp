@@ -0,0 +1,502 @@
+/**
+ * \file assembly.hpp
+ *
+ * Multithreaded assembly of the Laplace system shared by the Poisson problems
+ */
+
+#pragma once
+
+#include "functions.hpp"
+
+#include <deal.II/base/work_stream.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/geometry_info.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+
+#ifdef DEAL_II_WITH_TBB
+#  include <tbb/task_arena.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace dealii;
+
+/**
+ *  Local contributions of one cell that are handed from a worker thread to the copier.
+ */
+struct AssemblyCopyData
+{
+  FullMatrix<double> cell_matrix;       //!< Local stiffness matrix
+  Vector<double> cell_rhs;              //!< Local right hand side
+  std::vector<types::global_dof_index> local_dof_indices; //!< Global indices of the local degrees of freedom
+};
+
+/**
+ *  Local systems of the last cells a worker thread has assembled, keyed by the vertices of the cell relative to its first
+ *  vertex. The default mapping only depends on the vertices, so cells that are translations of each other have the same
+ *  Jacobians and, for a constant source and coefficient, the same local matrix and right hand side. On the grids of
+ *  GridGenerator::hyper_rectangle() and refine_global() all cells are congruent, so every thread only computes its first
+ *  cell. The cache keeps a few classes, which covers the cells of the different levels of locally refined grids.
+ */
+template <int dim>
+class CongruentCellCache
+{
+public:
+  /**
+   *  Copy the local system of a cached cell that is congruent to the given cell into the copy data.
+   *
+   *  \return False if no congruent cell is cached, the copy data is not changed then
+   */
+  template <class Iterator>
+  bool find(const Iterator &cell, AssemblyCopyData &copy_data) const
+  {
+    const Shape shape = cell_shape(cell);
+    for (const Entry &entry : entries)
+      if (congruent(entry.shape, shape))
+        {
+          copy_data.cell_matrix = entry.cell_matrix;
+          copy_data.cell_rhs = entry.cell_rhs;
+          copy_data.local_dof_indices.resize(entry.cell_rhs.size());
+          cell->get_dof_indices(copy_data.local_dof_indices);
+          return true;
+        }
+    return false;
+  }
+
+  /**
+   *  Store the local system of a cell, the oldest class is replaced if the cache is full.
+   */
+  template <class Iterator>
+  void add(const Iterator &cell, const AssemblyCopyData &copy_data)
+  {
+    if (entries.size() < max_entries)
+      entries.emplace_back();
+    Entry &entry = entries[next_entry];
+    entry.shape = cell_shape(cell);
+    entry.cell_matrix = copy_data.cell_matrix;
+    entry.cell_rhs = copy_data.cell_rhs;
+    next_entry = (next_entry + 1) % max_entries;
+  }
+
+private:
+  static constexpr unsigned int max_entries = 8; //!< Maximum number of cached classes
+  using Shape = std::array<double, dim * (GeometryInfo<dim>::vertices_per_cell - 1)>; //!< Vertices relative to the first vertex
+
+  /**
+   *  Local system of one class of congruent cells.
+   */
+  struct Entry
+  {
+    Shape shape;                        //!< Vertices of the cells relative to their first vertex
+    FullMatrix<double> cell_matrix;     //!< Local stiffness matrix
+    Vector<double> cell_rhs;            //!< Local right hand side
+  };
+
+  std::vector<Entry> entries;           //!< Cached classes
+  unsigned int next_entry = 0;          //!< Entry that is replaced next
+
+  /**
+   *  Vertices of the cell relative to its first vertex.
+   */
+  template <class Iterator>
+  static Shape cell_shape(const Iterator &cell)
+  {
+    Shape shape;
+    for (unsigned int v = 1; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+      for (unsigned int d = 0; d < dim; ++d)
+        shape[(v - 1) * dim + d] = cell->vertex(v)[d] - cell->vertex(0)[d];
+    return shape;
+  }
+
+  /**
+   *  Compare two shapes up to rounding errors of the vertex coordinates, relative to the size of the cells.
+   */
+  static bool congruent(const Shape &a, const Shape &b)
+  {
+    double size = 0.;
+    for (const double x : a)
+      size = std::max(size, std::fabs(x));
+    for (unsigned int k = 0; k < a.size(); ++k)
+      if (std::fabs(a[k] - b[k]) > 1e-12 * size)
+        return false;
+    return true;
+  }
+};
+
+/**
+ *  Per-thread scratch data for the assembly. Every worker thread gets its own FEValues object, so the
+ *  shape functions and the mapping can be evaluated on different cells at the same time.
+ */
+template <int dim>
+struct AssemblyScratchData
+{
+  AssemblyScratchData(const FiniteElement<dim> &fe,
+                      const Quadrature<dim> &quadrature,
+                      const UpdateFlags update_flags = update_values | update_gradients | update_quadrature_points |
+                                                       update_JxW_values);
+  AssemblyScratchData(const AssemblyScratchData<dim> &scratch_data);
+
+  FEValues<dim> fe_values;              //!< Shape function values and gradients on the current cell
+  CongruentCellCache<dim> congruent_cells; //!< Local systems of the congruent cells assembled by this thread
+};
+
+/**
+	 * Constructor for the scratch data
+	 *
+	 * \param fe Finite element of the problem.
+   * \param quadrature Quadrature formula used on every cell.
+   * \param update_flags Quantities FEValues computes on every cell, the default is what local_assemble_system() needs.
+	 * \return Constructed scratch data object
+	 */
+template <int dim>
+AssemblyScratchData<dim>::AssemblyScratchData(const FiniteElement<dim> &fe,
+                                              const Quadrature<dim> &quadrature,
+                                              const UpdateFlags update_flags)
+  : fe_values(fe, quadrature, update_flags)
+{}
+
+/**
+	 * Copy constructor for the scratch data. FEValues can not be copied, so a new object with the same finite element,
+   * quadrature and update flags is created for every worker thread. Every thread starts with an empty cache of congruent cells.
+	 *
+	 * \param scratch_data Scratch data to copy the settings from.
+	 * \return Constructed scratch data object
+	 */
+template <int dim>
+AssemblyScratchData<dim>::AssemblyScratchData(const AssemblyScratchData<dim> &scratch_data)
+  : fe_values(scratch_data.fe_values.get_fe(),
+              scratch_data.fe_values.get_quadrature(),
+              scratch_data.fe_values.get_update_flags())
+{}
+
+/**
+	 * Compute the local stiffness matrix and right hand side of one cell for the Poisson equation -div(a grad u) = f. The source f and
+   * the coefficient a are read from their quadrature value caches, without a function they are 1.
+   *
+   * \param cell Active cell to compute the local system on.
+   * \param scratch_data FEValues of the calling thread.
+   * \param copy_data Local matrix, right hand side and dof indices of the cell.
+   * \param source Source term f.
+   * \param coefficient Coefficient a, e.g. the permittivity.
+ 	 *
+	 */
+template <int dim>
+void local_assemble_system(const typename DoFHandler<dim>::active_cell_iterator &cell,
+                           AssemblyScratchData<dim> &scratch_data,
+                           AssemblyCopyData &copy_data,
+                           QuadratureValueCache<dim> &source,
+                           QuadratureValueCache<dim> &coefficient)
+{
+  FEValues<dim> &fe_values = scratch_data.fe_values;
+  const unsigned int dofs_per_cell = fe_values.get_fe().n_dofs_per_cell();
+
+  copy_data.cell_matrix.reinit(dofs_per_cell, dofs_per_cell);
+  copy_data.cell_rhs.reinit(dofs_per_cell);
+  copy_data.local_dof_indices.resize(dofs_per_cell);
+
+  fe_values.reinit(cell);
+  const std::vector<double> *source_values =
+    source.get_function() ? &source.cell_values(cell->active_cell_index(), fe_values) : nullptr;
+  const std::vector<double> *coefficient_values =
+    coefficient.get_function() ? &coefficient.cell_values(cell->active_cell_index(), fe_values) : nullptr;
+
+  for (const unsigned int q_index : fe_values.quadrature_point_indices())
+    {
+      const double source_value = source_values ? (*source_values)[q_index] : 1.;
+      const double coefficient_value = coefficient_values ? (*coefficient_values)[q_index] : 1.;
+      for (const unsigned int i : fe_values.dof_indices())
+        for (const unsigned int j : fe_values.dof_indices())
+          copy_data.cell_matrix(i, j) +=
+            (coefficient_value *                // a(x_q)
+             fe_values.shape_grad(i, q_index) * // grad phi_i(x_q)
+             fe_values.shape_grad(j, q_index) * // grad phi_j(x_q)
+             fe_values.JxW(q_index));           // dx
+      for (const unsigned int i : fe_values.dof_indices())
+        copy_data.cell_rhs(i) += (fe_values.shape_value(i, q_index) * // phi_i(x_q)
+                                  source_value *                      // f(x_q)
+                                  fe_values.JxW(q_index));            // dx
+    }
+  cell->get_dof_indices(copy_data.local_dof_indices);
+}
+
+/**
+ *  Shape function values and gradients of an FE_Q element of degree fe_degree on the reference cell, at the points of the
+ *  Gauss formula with fe_degree + 1 points per direction. The sizes are compile time constants, so the loops of the
+ *  specialized cell kernel have fixed trip counts that the compiler can unroll and vectorize. The entries of one quadrature
+ *  point are stored contiguously for all shape functions, the innermost loops of the kernel run over them with unit stride.
+ */
+template <int dim, int fe_degree>
+struct ReferenceCellData
+{
+  static constexpr unsigned int dofs_per_cell = Utilities::pow(fe_degree + 1, dim); //!< Number of shape functions
+  static constexpr unsigned int n_q_points = Utilities::pow(fe_degree + 1, dim);    //!< Number of quadrature points
+
+  ReferenceCellData(const FiniteElement<dim> &fe, const Quadrature<dim> &quadrature);
+
+  std::array<double, n_q_points * dofs_per_cell> values;          //!< Value of shape function i at point q, index q * dofs_per_cell + i
+  std::array<double, n_q_points * dim * dofs_per_cell> gradients; //!< Reference gradient component d, index (q * dim + d) * dofs_per_cell + i
+};
+
+/**
+	 * Constructor for the reference cell data, evaluates the shape functions once for all cells.
+	 *
+	 * \param fe FE_Q element of degree fe_degree.
+   * \param quadrature Gauss formula with fe_degree + 1 points per direction, the same as the one of the scratch data.
+	 * \return Constructed reference cell data object
+	 */
+template <int dim, int fe_degree>
+ReferenceCellData<dim, fe_degree>::ReferenceCellData(const FiniteElement<dim> &fe, const Quadrature<dim> &quadrature)
+{
+  AssertDimension(fe.n_dofs_per_cell(), dofs_per_cell);
+  AssertDimension(quadrature.size(), n_q_points);
+
+  for (unsigned int q = 0; q < n_q_points; ++q)
+    for (unsigned int i = 0; i < dofs_per_cell; ++i)
+      {
+        values[q * dofs_per_cell + i] = fe.shape_value(i, quadrature.point(q));
+        const Tensor<1, dim> gradient = fe.shape_grad(i, quadrature.point(q));
+        for (unsigned int d = 0; d < dim; ++d)
+          gradients[(q * dim + d) * dofs_per_cell + i] = gradient[d];
+      }
+}
+
+/**
+	 * Compute the local stiffness matrix and right hand side of one cell like local_assemble_system(), but for an FE_Q element whose
+   * degree and dimension are known at compile time. FEValues only computes the Jacobians, the shape functions are taken from the
+   * reference cell data: with the inverse Jacobian K, grad phi_i . grad phi_j = g_i^T K K^T g_j for the reference gradients g, so
+   * the mapping is applied once per quadrature point to the dim x dim metric instead of once per shape function. The matrix is
+   * symmetric, only the upper triangle is accumulated and mirrored at the end.
+   *
+   * \param reference Reference cell data of the element.
+   * \param cell Active cell to compute the local system on.
+   * \param scratch_data FEValues of the calling thread with inverse Jacobians, JxW values and quadrature points.
+   * \param copy_data Local matrix, right hand side and dof indices of the cell.
+   * \param source Source term f.
+   * \param coefficient Coefficient a, e.g. the permittivity.
+ 	 *
+	 */
+template <int dim, int fe_degree>
+void local_assemble_system(const ReferenceCellData<dim, fe_degree> &reference,
+                           const typename DoFHandler<dim>::active_cell_iterator &cell,
+                           AssemblyScratchData<dim> &scratch_data,
+                           AssemblyCopyData &copy_data,
+                           QuadratureValueCache<dim> &source,
+                           QuadratureValueCache<dim> &coefficient)
+{
+  constexpr unsigned int dofs_per_cell = ReferenceCellData<dim, fe_degree>::dofs_per_cell;
+  constexpr unsigned int n_q_points = ReferenceCellData<dim, fe_degree>::n_q_points;
+  FEValues<dim> &fe_values = scratch_data.fe_values;
+
+  copy_data.cell_matrix.reinit(dofs_per_cell, dofs_per_cell);
+  copy_data.cell_rhs.reinit(dofs_per_cell);
+  copy_data.local_dof_indices.resize(dofs_per_cell);
+
+  fe_values.reinit(cell);
+  const std::vector<double> *source_values =
+    source.get_function() ? &source.cell_values(cell->active_cell_index(), fe_values) : nullptr;
+  const std::vector<double> *coefficient_values =
+    coefficient.get_function() ? &coefficient.cell_values(cell->active_cell_index(), fe_values) : nullptr;
+
+  std::array<double, dofs_per_cell * dofs_per_cell> cell_matrix{};
+  std::array<double, dofs_per_cell> cell_rhs{};
+  for (unsigned int q_index = 0; q_index < n_q_points; ++q_index)
+    {
+      const double *values = &reference.values[q_index * dofs_per_cell];
+      const double *gradients = &reference.gradients[q_index * dim * dofs_per_cell];
+      const double source_value = source_values ? (*source_values)[q_index] : 1.;
+      const double coefficient_value = coefficient_values ? (*coefficient_values)[q_index] : 1.;
+      const double JxW = fe_values.JxW(q_index);
+
+      // a(x_q) K K^T dx
+      const DerivativeForm<1, dim, dim> &inverse_jacobian = fe_values.inverse_jacobian(q_index);
+      double metric[dim][dim];
+      for (unsigned int d = 0; d < dim; ++d)
+        for (unsigned int e = 0; e < dim; ++e)
+          {
+            double sum = 0.;
+            for (unsigned int k = 0; k < dim; ++k)
+              sum += inverse_jacobian[d][k] * inverse_jacobian[e][k];
+            metric[d][e] = coefficient_value * sum * JxW;
+          }
+
+      // a(x_q) K K^T g_j dx for all shape functions j
+      double metric_gradients[dim][dofs_per_cell];
+      for (unsigned int d = 0; d < dim; ++d)
+        for (unsigned int j = 0; j < dofs_per_cell; ++j)
+          {
+            double sum = 0.;
+            for (unsigned int e = 0; e < dim; ++e)
+              sum += metric[d][e] * gradients[e * dofs_per_cell + j];
+            metric_gradients[d][j] = sum;
+          }
+
+      for (unsigned int i = 0; i < dofs_per_cell; ++i)
+        for (unsigned int d = 0; d < dim; ++d)
+          {
+            const double gradient = gradients[d * dofs_per_cell + i];
+            for (unsigned int j = i; j < dofs_per_cell; ++j)
+              cell_matrix[i * dofs_per_cell + j] += gradient * metric_gradients[d][j];
+          }
+      for (unsigned int i = 0; i < dofs_per_cell; ++i)
+        cell_rhs[i] += values[i] * source_value * JxW;
+    }
+
+  for (unsigned int i = 0; i < dofs_per_cell; ++i)
+    {
+      copy_data.cell_matrix(i, i) = cell_matrix[i * dofs_per_cell + i];
+      for (unsigned int j = i + 1; j < dofs_per_cell; ++j)
+        {
+          copy_data.cell_matrix(i, j) = cell_matrix[i * dofs_per_cell + j];
+          copy_data.cell_matrix(j, i) = cell_matrix[i * dofs_per_cell + j];
+        }
+      copy_data.cell_rhs(i) = cell_rhs[i];
+    }
+  cell->get_dof_indices(copy_data.local_dof_indices);
+}
+
+/**
+	 * Assemble the Laplace system with the specialized kernel for an FE_Q element of degree fe_degree, see assemble_laplace_system().
+   * The reference cell data is computed once and shared by all worker threads. With reuse_cells the local systems of congruent
+   * cells are copied from the cache of the thread instead of computed again.
+ 	 *
+	 */
+template <int dim, int fe_degree>
+void assemble_specialized_laplace_system(const DoFHandler<dim> &dof_handler,
+                                         const AffineConstraints<double> &constraints,
+                                         SparseMatrix<double> &matrix,
+                                         Vector<double> &rhs,
+                                         QuadratureValueCache<dim> &source,
+                                         QuadratureValueCache<dim> &coefficient,
+                                         const bool reuse_cells)
+{
+  const FiniteElement<dim> &fe = dof_handler.get_fe();
+  const QGauss<dim> quadrature_formula(fe_degree + 1);
+  const auto reference = std::make_unique<ReferenceCellData<dim, fe_degree>>(fe, quadrature_formula);
+
+  WorkStream::run(dof_handler.begin_active(),
+                  dof_handler.end(),
+                  [&reference, &source, &coefficient, reuse_cells](const typename DoFHandler<dim>::active_cell_iterator &cell,
+                                                                   AssemblyScratchData<dim> &scratch_data,
+                                                                   AssemblyCopyData &copy_data) {
+                    if (reuse_cells && scratch_data.congruent_cells.find(cell, copy_data))
+                      return;
+                    local_assemble_system<dim, fe_degree>(*reference, cell, scratch_data, copy_data, source, coefficient);
+                    if (reuse_cells)
+                      scratch_data.congruent_cells.add(cell, copy_data);
+                  },
+                  [&constraints, &matrix, &rhs](const AssemblyCopyData &copy_data) {
+                    constraints.distribute_local_to_global(copy_data.cell_matrix,
+                                                           copy_data.cell_rhs,
+                                                           copy_data.local_dof_indices,
+                                                           matrix,
+                                                           rhs);
+                  },
+                  AssemblyScratchData<dim>(fe,
+                                           quadrature_formula,
+                                           update_inverse_jacobians | update_quadrature_points | update_JxW_values),
+                  AssemblyCopyData());
+}
+
+/**
+	 * Assemble the stiffness matrix and right hand side of the Poisson equation without boundary values. The cells are distributed
+   * to worker threads with WorkStream, each thread computes local contributions with its own scratch data. Only the copier writes
+   * into the global matrix and right hand side, and it runs on one thread at a time, so no locking of matrix rows is needed. The
+   * copier resolves the hanging node constraints of locally refined grids while adding the local contributions, the constrained
+   * rows only keep a diagonal entry and the solution has to be completed with AffineConstraints::distribute() after solving.
+   *
+   * \param dof_handler DoFHandler with distributed degrees of freedom.
+   * \param constraints Hanging node constraints of the grid, empty for uniformly refined grids.
+   * \param matrix Matrix initialized with the sparsity pattern of the problem, the cell matrices are added to it.
+   * \param rhs Vector of size n_dofs, the cell right hand sides are added to it.
+   * \param source Source term f, its values are stored for later assemblies on the same grid.
+   * \param coefficient Coefficient a, its values are stored for later assemblies on the same grid.
+   * \param n_threads Maximum number of threads of this assembly, 0 uses the thread limit of deal.II, by default one thread per core.
+   * The limit only applies to a task arena around the assembly, the thread limit of deal.II for the rest of the process is not changed.
+   * \param specialized Use the kernels with compile time loop bounds for FE_Q elements of degree 1 to 3, false always uses the generic loop.
+   * \param reuse_congruent_cells Copy the local systems of congruent cells instead of computing them again, only used if the source and
+   * the coefficient are constant, see CongruentCellCache.
+ 	 *
+	 */
+template <int dim>
+void assemble_laplace_system(const DoFHandler<dim> &dof_handler,
+                             const AffineConstraints<double> &constraints,
+                             SparseMatrix<double> &matrix,
+                             Vector<double> &rhs,
+                             QuadratureValueCache<dim> &source,
+                             QuadratureValueCache<dim> &coefficient,
+                             const unsigned int n_threads,
+                             const bool specialized = true,
+                             const bool reuse_congruent_cells = true)
+{
+  const auto assemble = [&]() {
+    const FiniteElement<dim> &fe = dof_handler.get_fe();
+    const QGauss<dim> quadrature_formula(fe.degree + 1);
+    source.prepare(dof_handler.get_triangulation().n_active_cells());
+    coefficient.prepare(dof_handler.get_triangulation().n_active_cells());
+    const bool reuse_cells = reuse_congruent_cells && !source.get_function() && !coefficient.get_function();
+
+    if (specialized && dynamic_cast<const FE_Q<dim> *>(&fe) != nullptr)
+      switch (fe.degree)
+        {
+          case 1:
+            assemble_specialized_laplace_system<dim, 1>(dof_handler, constraints, matrix, rhs, source, coefficient,
+                                                        reuse_cells);
+            return;
+          case 2:
+            assemble_specialized_laplace_system<dim, 2>(dof_handler, constraints, matrix, rhs, source, coefficient,
+                                                        reuse_cells);
+            return;
+          case 3:
+            assemble_specialized_laplace_system<dim, 3>(dof_handler, constraints, matrix, rhs, source, coefficient,
+                                                        reuse_cells);
+            return;
+          default:
+            break;
+        }
+
+    WorkStream::run(dof_handler.begin_active(),
+                    dof_handler.end(),
+                    [&source, &coefficient, reuse_cells](const typename DoFHandler<dim>::active_cell_iterator &cell,
+                                                         AssemblyScratchData<dim> &scratch_data,
+                                                         AssemblyCopyData &copy_data) {
+                      if (reuse_cells && scratch_data.congruent_cells.find(cell, copy_data))
+                        return;
+                      local_assemble_system<dim>(cell, scratch_data, copy_data, source, coefficient);
+                      if (reuse_cells)
+                        scratch_data.congruent_cells.add(cell, copy_data);
+                    },
+                    [&constraints, &matrix, &rhs](const AssemblyCopyData &copy_data) {
+                      constraints.distribute_local_to_global(copy_data.cell_matrix,
+                                                             copy_data.cell_rhs,
+                                                             copy_data.local_dof_indices,
+                                                             matrix,
+                                                             rhs);
+                    },
+                    AssemblyScratchData<dim>(fe, quadrature_formula),
+                    AssemblyCopyData());
+  };
+
+#ifdef DEAL_II_WITH_TBB
+  if (n_threads > 0)
+    {
+      tbb::task_arena arena(n_threads);
+      arena.execute(assemble);
+      return;
+    }
+#endif
+  assemble();
+}
@@ -0,0 +1,202 @@
+/**
+ * \file distributed_poisson.hpp
+ *
+ * MPI parallel Poisson solver on a distributed triangulation
+ */
+
+#pragma once
+
+#include "poisson.hpp"
+
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/timer.h>
+
+#ifdef DEAL_II_WITH_P4EST
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+using namespace dealii;
+
+/**
+ *  Class for calculating the poisson problem on a hyper rectangular domain on several MPI processes. Every process only
+ *  stores its own part of the triangulation, the degrees of freedom of its cells and its part of the vectors, so the size
+ *  of the problem grows with the number of nodes. The Laplace operator is applied matrix-free, see MatrixFreeLaplace,
+ *  and the CG solver with the Chebyshev preconditioner communicates through the distributed vectors. Needs deal.II with
+ *  p4est and MPI.
+ */
+template <int dim>
+class DistributedPoisson
+{
+public:
+  DistributedPoisson(MPI_Comm _mpi_communicator, std::vector<int> _dimensions, int _refinement, int _shape_function, int _bc,
+                     bool _homogeneous, SolverOptions _options = SolverOptions());
+  SolveStatistics run();
+private:
+  void make_grid();
+  void setup_system();
+  void solve();
+  void output_results();
+
+  MPI_Comm mpi_communicator;            //!< Communicator of all processes that share the problem
+  int refinement;                       //!< Refinement of triangulation
+  int bc;                               //!< Constant boundary condition
+  bool homogeneous;                     //!< If false, non-homogeneous BC are applied
+  SolverOptions options;                //!< Options for the linear solver and the output
+  ConditionalOStream pcout;             //!< Output stream that only prints on the first process
+  TimerOutput computing_timer;          //!< Wall time of the phases of the current run
+  SolveStatistics statistics;           //!< Statistics of the current run
+
+  parallel::distributed::Triangulation<dim> triangulation; //!< Triangulation of which every process owns a part
+  FE_Q<dim>          fe;                //!< Implementation of scalar Lagrange finite element  that yields the finite element space.
+  HyperRectangle<dim> geometry;         //!< Creates the coarse grid, see geometry.hpp
+  DoFHandler<dim>    dof_handler;       //!< Global numbering of degrees of freedom
+  LinearAlgebra::distributed::Vector<double> solution; //!< Locally owned part of the solution with ghost entries
+  std::unique_ptr<MatrixFreeProblem<dim>> matrix_free_problem; //!< Matrix-free solver on the locally owned cells
+};
+
+/**
+	 * Constructor for DistributedPoisson class
+	 *
+	 * \param _mpi_communicator Communicator of the processes that share the problem, usually MPI_COMM_WORLD.
+	 * \param _dimensions Dimensions of hyper rectangle defined by two points: origin and point with dimensions coordinates.
+   * \param _refinement Refine all cells _refinement times.
+   * \param _shape_function Degree of continuous, piecewise polynomials for finite element space of Lagrangian finite elements, 1 to 3.
+   * \param _bc Constant Dirichlet boundary values
+   * \param _homogeneous If true, the constant boundary values are applied, otherwise the ones given by BoundaryValues
+   * \param _options Options for the linear solver, only the iteration limit, the tolerance and the output are used
+	 * \return Constructed distributed poisson class object
+	 */
+template <int dim>
+DistributedPoisson<dim>::DistributedPoisson(MPI_Comm _mpi_communicator, std::vector<int> _dimensions,
+                                            int _refinement, int _shape_function, int _bc, bool _homogeneous,
+                                            SolverOptions _options)
+  : mpi_communicator(_mpi_communicator), refinement(_refinement), bc(_bc), homogeneous(_homogeneous), options(_options),
+    pcout(std::cout, Utilities::MPI::this_mpi_process(_mpi_communicator) == 0),
+    computing_timer(_mpi_communicator, pcout, TimerOutput::never, TimerOutput::wall_times),
+    triangulation(_mpi_communicator), fe(_shape_function), geometry(_dimensions), dof_handler(triangulation)
+{
+  make_grid();
+}
+
+/**
+	 * Create the hyper rectangular grid. Every process refines the coarse grid, p4est partitions the refined cells, so every process
+   * only keeps its own cells and one layer of ghost cells.
+ 	 *
+	 */
+template <int dim>
+void DistributedPoisson<dim>::make_grid()
+{
+  report_progress(options.progress, SolvePhase::grid);
+  TimerOutput::Scope timer_section(computing_timer, Sections::grid);
+  geometry.create_grid(triangulation, refinement);
+  pcout << "   Number of active cells: " << triangulation.n_global_active_cells()
+        << std::endl
+        << "   Number of processes: " << Utilities::MPI::n_mpi_processes(mpi_communicator)
+        << std::endl;
+}
+
+/**
+	 * Enumerate all degrees of freedom and set up the matrix-free operator on the locally owned cells.
+ 	 *
+	 */
+template <int dim>
+void DistributedPoisson<dim>::setup_system()
+{
+  report_progress(options.progress, SolvePhase::dofs);
+  TimerOutput::Scope timer_section(computing_timer, Sections::setup);
+  dof_handler.distribute_dofs(fe);
+  pcout << "   Number of degrees of freedom: " << dof_handler.n_dofs()
+        << std::endl;
+
+  matrix_free_problem = create_matrix_free_problem<dim>(fe.degree);
+  matrix_free_problem->initialize(dof_handler);
+}
+
+/**
+	 * Solve the discretized equation with the matrix-free CG solver. Every process interpolates the boundary values on its own and its
+   * ghost cells, the lifting of the boundary values is done by the solver.
+ 	 *
+	 */
+template <int dim>
+void DistributedPoisson<dim>::solve()
+{
+  report_progress(options.progress, SolvePhase::solve);
+  TimerOutput::Scope timer_section(computing_timer, Sections::solve);
+  std::map<types::global_dof_index, double> boundary_values;
+  if(homogeneous)
+    VectorTools::interpolate_boundary_values(dof_handler,0,Functions::ConstantFunction<dim>(bc),boundary_values);
+  else
+    VectorTools::interpolate_boundary_values(dof_handler,0,BoundaryValues<dim>(),boundary_values);
+
+  const unsigned int max_iterations = options.max_iterations > 0 ? options.max_iterations
+                                                                 : std::max<unsigned int>(1000, dof_handler.n_dofs());
+  ProgressSolverControl    solver_control(max_iterations, options.tolerance, options.progress);
+  matrix_free_problem->solve(boundary_values, solver_control, solution);
+  pcout << "   " << solver_control.last_step()
+        << " CG iterations with matrix-free Chebyshev preconditioner needed to obtain convergence (residual "
+        << solver_control.last_value() << ")." << std::endl;
+  statistics.cg_iterations = solver_control.last_step();
+  statistics.residual = solver_control.last_value();
+}
+
+/**
+	 * Write the solution as one VTU piece per process and a PVTU record that combines them. The other output formats of the solver
+   * options are written by one process only and are not supported here.
+ 	 *
+	 */
+template <int dim>
+void DistributedPoisson<dim>::output_results()
+{
+  report_progress(options.progress, SolvePhase::output);
+  TimerOutput::Scope timer_section(computing_timer, Sections::output);
+  if (!options.write_output)
+    return;
+
+  solution.update_ghost_values();
+  Vector<float> subdomain(triangulation.n_active_cells());
+  for (unsigned int i = 0; i < subdomain.size(); ++i)
+    subdomain(i) = triangulation.locally_owned_subdomain();
+
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler(dof_handler);
+  data_out.add_data_vector(solution, "solution");
+  data_out.add_data_vector(subdomain, "subdomain");
+  data_out.build_patches();
+
+  DataOutBase::VtkFlags vtk_flags;
+  vtk_flags.compression_level = DataOutBase::VtkFlags::best_speed;
+  data_out.set_flags(vtk_flags);
+  const std::string name = options.output_name.empty() ? "solution-" + std::to_string(dim) + "d-mpi" : options.output_name;
+  data_out.write_vtu_with_pvtu_record(options.output_directory, name, 0, mpi_communicator, 4);
+}
+
+/**
+	 * Set up and solve the problem on all processes and write the result. Has to be called by every process of the communicator.
+   *
+   * \return Statistics of the run, the times are the ones of the first process and the peak memory is the maximum over all processes
+ 	 *
+	 */
+template <int dim>
+SolveStatistics DistributedPoisson<dim>::run()
+{
+  pcout << "Solving problem in " << dim << " space dimensions on "
+        << Utilities::MPI::n_mpi_processes(mpi_communicator) << " processes." << std::endl;
+  setup_system();
+  solve();
+  output_results();
+
+  statistics.n_dofs = dof_handler.n_dofs();
+  statistics.n_active_cells = triangulation.n_global_active_cells();
+  collect_statistics(computing_timer, statistics);
+  statistics.peak_memory = Utilities::MPI::max(statistics.peak_memory, mpi_communicator);
+  if (options.print_timings)
+    computing_timer.print_summary();
+  computing_timer.reset();
+  return statistics;
+}
+
+#endif // DEAL_II_WITH_P4EST
@@ -0,0 +1,137 @@
+/**
+ * \file functions.hpp
+ *
+ * Source and coefficient functions of the Poisson problems with cached values at the quadrature points
+ */
+
+#pragma once
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/memory_consumption.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_values.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace dealii;
+
+/**
+ *  Scalar function that is evaluated for a whole list of points with one call. The default value_list() of Function, which is
+ *  also used by ScalarFunctionFromFunctionObject, calls the virtual value() for every point. This function hands all points to
+ *  the evaluator instead, e.g. a vectorized kernel or a lookup in a field that was imported once for the whole list. The
+ *  assembly and the matrix-free operator call value_list() once per cell or cell batch.
+ */
+template <int dim>
+class PointListFunction : public Function<dim>
+{
+public:
+  using Evaluator = std::function<void(const std::vector<Point<dim>> &points, std::vector<double> &values)>;
+
+  /**
+   *  Constructor with the evaluator, which receives the points and fills the values, the values already have the size of the points.
+   */
+  PointListFunction(const Evaluator &_evaluator)
+    : evaluator(_evaluator)
+  {}
+
+  /**
+   *  Value at a single point, evaluated as a list with one point.
+   */
+  double value(const Point<dim> &point, const unsigned int = 0) const override
+  {
+    std::vector<double> values(1);
+    evaluator(std::vector<Point<dim>>(1, point), values);
+    return values[0];
+  }
+
+  /**
+   *  Values at all points with one call of the evaluator.
+   */
+  void value_list(const std::vector<Point<dim>> &points, std::vector<double> &values, const unsigned int = 0) const override
+  {
+    AssertDimension(points.size(), values.size());
+    evaluator(points, values);
+  }
+
+private:
+  Evaluator evaluator; //!< Evaluates the function for a list of points
+};
+
+/**
+ *  Function of the Poisson problem, e.g. the source term or the coefficient, together with its values at the quadrature
+ *  points of all active cells. The function is evaluated with one value_list() call for all quadrature points of a cell, and
+ *  only the first time a cell is assembled. Further assemblies on the same grid, e.g. after another function has been changed,
+ *  read the stored values. A PointListFunction evaluates the points of the cell in one call of its evaluator, other functions
+ *  keep the default value_list() of deal.II, which calls value() for every point. Without a function the problem uses the
+ *  constant 1.
+ */
+template <int dim>
+class QuadratureValueCache
+{
+public:
+  /**
+   *  Set a new function, the values of the old one are discarded. nullptr selects the constant 1.
+   */
+  void set_function(const std::shared_ptr<const Function<dim>> &_function)
+  {
+    function = _function;
+    clear();
+  }
+
+  /**
+   *  Function of the cache, nullptr for the constant 1.
+   */
+  const Function<dim> *get_function() const
+  {
+    return function.get();
+  }
+
+  /**
+   *  Discard all values, has to be called when the grid changes.
+   */
+  void clear()
+  {
+    values.clear();
+  }
+
+  /**
+   *  Make room for the values of all active cells before the cells are assembled in parallel. Values that are already
+   *  stored for a grid with the same number of cells are kept.
+   */
+  void prepare(const unsigned int n_active_cells)
+  {
+    if (values.size() != n_active_cells)
+      values.assign(n_active_cells, std::vector<double>());
+  }
+
+  /**
+   *  Values of the function at the quadrature points of the cell that fe_values has been reinitialized with. Every cell is
+   *  only accessed by one thread at a time, so different cells can be evaluated concurrently.
+   */
+  const std::vector<double> &cell_values(const unsigned int active_cell_index, const FEValues<dim> &fe_values)
+  {
+    std::vector<double> &cell_values = values[active_cell_index];
+    if (cell_values.empty())
+      {
+        cell_values.resize(fe_values.n_quadrature_points);
+        function->value_list(fe_values.get_quadrature_points(), cell_values);
+      }
+    return cell_values;
+  }
+
+  /**
+   *  Memory used by the stored values in bytes.
+   */
+  std::size_t memory_consumption() const
+  {
+    return MemoryConsumption::memory_consumption(values);
+  }
+
+private:
+  std::shared_ptr<const Function<dim>> function; //!< Function that is evaluated, nullptr for the constant 1
+  std::vector<std::vector<double>> values;  //!< Values at the quadrature points of every active cell, empty if not yet evaluated
+};
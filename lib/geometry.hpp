@@ -0,0 +1,180 @@
+/**
+ * \file geometry.hpp
+ *
+ * Geometry policies that create the coarse grid of the Poisson problems
+ */
+
+#pragma once
+
+#include <deal.II/base/point.h>
+#include <deal.II/base/exceptions.h>
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_in.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace dealii;
+
+/**
+ *  Hyper rectangle between the origin and a corner point. All boundary faces get the boundary id 0.
+ */
+template <int dim>
+class HyperRectangle
+{
+public:
+  /**
+   *  \param dimensions Coordinates of the corner diagonally opposite to the origin, at least dim values.
+   */
+  HyperRectangle(const std::vector<int> &dimensions)
+  {
+    for (int i = 0; i < dim; i++)
+      corner[i] = dimensions[i];
+  }
+
+  /**
+   *  Create the hyper rectangle and refine all cells refinement times, which gives 2^{dim x refinement} cells.
+   */
+  void create_grid(Triangulation<dim> &triangulation, const unsigned int refinement) const
+  {
+    GridGenerator::hyper_rectangle(triangulation, Point<dim>(), corner, false);
+    triangulation.refine_global(refinement);
+  }
+
+  /**
+   *  Name of the problem for the solver output.
+   */
+  std::string description() const
+  {
+    return "problem";
+  }
+
+  /**
+   *  Default file name of the solution without extension.
+   */
+  std::string output_name() const
+  {
+    return "solution-" + std::to_string(dim) + "d";
+  }
+
+private:
+  Point<dim> corner;                    //!< Diagonally opposite corner point of hyper rectangle (p1 is origin)
+};
+
+/**
+ *  Ring in 2D or spherical shell in 3D between an inner and an outer radius. The curved boundaries follow the spherical
+ *  manifold that GridGenerator::hyper_shell() attaches, so refined cells lie on the circles or spheres. All boundary faces
+ *  get the boundary id 0.
+ */
+template <int dim>
+class HyperShell
+{
+public:
+  /**
+   *  \param radii Inner and outer radius.
+   */
+  HyperShell(const std::vector<double> &radii)
+    : inner_radius(radii[0]), outer_radius(radii[1])
+  {
+    AssertThrow(0 < inner_radius && inner_radius < outer_radius,
+                ExcMessage("The inner radius has to be positive and smaller than the outer radius."));
+    center[0] = 1;
+  }
+
+  /**
+   *  Create the shell and refine all cells refinement times. The solution changes fastest at the inner radius, so the cells
+   *  touching the inner boundary are refined three more times.
+   */
+  void create_grid(Triangulation<dim> &triangulation, const unsigned int refinement) const
+  {
+    GridGenerator::hyper_shell(triangulation, center, inner_radius, outer_radius);
+    triangulation.refine_global(refinement);
+    for (unsigned int step = 0; step < 3; ++step)
+      {
+        for (auto &cell : triangulation.active_cell_iterators())
+          for (const auto v : cell->vertex_indices())
+            {
+              const double distance_from_center = center.distance(cell->vertex(v));
+              if (std::fabs(distance_from_center - inner_radius) <= 1e-6 * inner_radius)
+                {
+                  cell->set_refine_flag();
+                  break;
+                }
+            }
+        triangulation.execute_coarsening_and_refinement();
+      }
+  }
+
+  /**
+   *  Name of the problem for the solver output.
+   */
+  std::string description() const
+  {
+    return "radial problem";
+  }
+
+  /**
+   *  Default file name of the solution without extension.
+   */
+  std::string output_name() const
+  {
+    return "solution-radial-" + std::to_string(dim) + "d";
+  }
+
+private:
+  Point<dim> center;                    //!< Center of the shell
+  double inner_radius;                  //!< Inner radius of the shell
+  double outer_radius;                  //!< Outer radius of the shell
+};
+
+/**
+ *  Coarse grid read from a file, e.g. a device geometry exported from a mesh generator. The format is deduced from the file
+ *  extension by GridIn, e.g. .msh for Gmsh, .inp for Abaqus or .vtk for legacy VTK. The Dirichlet values are applied on the
+ *  faces with boundary id 0, so the file has to mark the contacts with id 0.
+ */
+template <int dim>
+class ImportedMesh
+{
+public:
+  /**
+   *  \param _file_name Name of the mesh file.
+   */
+  ImportedMesh(const std::string &_file_name)
+    : file_name(_file_name)
+  {}
+
+  /**
+   *  Read the coarse grid and refine all cells refinement times.
+   */
+  void create_grid(Triangulation<dim> &triangulation, const unsigned int refinement) const
+  {
+    GridIn<dim> grid_in;
+    grid_in.attach_triangulation(triangulation);
+    grid_in.read(file_name);
+    triangulation.refine_global(refinement);
+  }
+
+  /**
+   *  Name of the problem for the solver output.
+   */
+  std::string description() const
+  {
+    return "problem on " + file_name;
+  }
+
+  /**
+   *  Default file name of the solution without extension.
+   */
+  std::string output_name() const
+  {
+    return "solution-mesh-" + std::to_string(dim) + "d";
+  }
+
+private:
+  std::string file_name;                //!< Name of the mesh file
+};
@@ -0,0 +1,83 @@
+/**
+ * \file initial_guess.hpp
+ *
+ * Initial guesses for the CG solver from the previous solutions on the same grid
+ */
+
+#pragma once
+
+#include "solver_options.hpp"
+
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+
+using namespace dealii;
+
+/**
+ *  The last two solutions of a Poisson problem on the current grid together with the boundary values they were computed for.
+ *  A re-solve with new boundary values starts the CG solver from the last solution or from the linear extrapolation of the
+ *  last two, instead of from zero. For constant boundary values the solution depends linearly on the boundary value, so the
+ *  extrapolation is already the solution up to the solver tolerance and CG only has to correct rounding errors.
+ */
+class SolutionHistory
+{
+public:
+  /**
+   *  Discard the stored solutions, has to be called when the grid or the system changes.
+   */
+  void clear()
+  {
+    n_solutions = 0;
+  }
+
+  /**
+   *  Store a converged solution, the oldest one is discarded.
+   */
+  void add(const Vector<double> &solution, const double boundary_value)
+  {
+    if (n_solutions > 0)
+      {
+        previous.swap(last);
+        previous_boundary_value = last_boundary_value;
+      }
+    last = solution;
+    last_boundary_value = boundary_value;
+    n_solutions = std::min(n_solutions + 1, 2u);
+  }
+
+  /**
+   *  Initial guess for the given boundary value, the boundary entries still have to be set to the new values.
+   *
+   *  \param boundary_value Boundary value of the next solve.
+   *  \param type Initial guess selected in the solver options.
+   *  \param guess Vector that receives the initial guess.
+   *  \return False if there is no stored solution or the zero initial guess is selected, guess is not changed then
+   */
+  bool initial_guess(const double boundary_value, const InitialGuessType type, Vector<double> &guess) const
+  {
+    if (type == InitialGuessType::zero || n_solutions == 0)
+      return false;
+
+    guess = last;
+    if (type == InitialGuessType::extrapolated && n_solutions == 2 && last_boundary_value != previous_boundary_value)
+      guess.add((boundary_value - last_boundary_value) / (last_boundary_value - previous_boundary_value), last,
+                -(boundary_value - last_boundary_value) / (last_boundary_value - previous_boundary_value), previous);
+    return true;
+  }
+
+  /**
+   *  Memory used by the stored solutions in bytes.
+   */
+  std::size_t memory_consumption() const
+  {
+    return last.memory_consumption() + previous.memory_consumption();
+  }
+
+private:
+  Vector<double> last;                  //!< Last solution
+  Vector<double> previous;              //!< Solution before the last one
+  double last_boundary_value = 0.;      //!< Boundary value of the last solution
+  double previous_boundary_value = 0.;  //!< Boundary value of the solution before the last one
+  unsigned int n_solutions = 0;         //!< Number of stored solutions, at most 2
+};
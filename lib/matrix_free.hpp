@@ -0,0 +1,314 @@
+/**
+ * \file matrix_free.hpp
+ *
+ * Matrix-free evaluation of the Laplace operator for the Poisson problems
+ */
+
+#pragma once
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/function.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/precondition.h>
+
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/operators.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace dealii;
+
+/**
+ *  Interface of the matrix-free Poisson solver. The polynomial degree is a template parameter of the implementation,
+ *  this interface allows to select it at run time, see create_matrix_free_problem().
+ */
+template <int dim>
+class MatrixFreeProblem
+{
+public:
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+  virtual ~MatrixFreeProblem() = default;
+
+  /**
+   *  Set up the constraints, the precomputed geometry data of all cells, the values of the source and the coefficient at the
+   *  quadrature points and the diagonal of the operator. Without a source or a coefficient the constant 1 is used.
+   */
+  virtual void initialize(const DoFHandler<dim> &dof_handler,
+                          const Function<dim> *source = nullptr,
+                          const Function<dim> *coefficient = nullptr) = 0;
+
+  /**
+   *  Solve the Poisson equation -div(a grad u) = f with the given Dirichlet values on boundary 0. The solution
+   *  is distributed like the degrees of freedom of a parallel triangulation, the boundary values have to contain at least
+   *  the boundary degrees of freedom of the locally owned cells.
+   */
+  virtual void solve(const std::map<types::global_dof_index, double> &boundary_values,
+                     SolverControl &solver_control,
+                     VectorType &solution) = 0;
+
+  /**
+   *  Solve the Poisson equation on a serial triangulation and copy the solution into a serial vector.
+   */
+  void solve(const std::map<types::global_dof_index, double> &boundary_values,
+             SolverControl &solver_control,
+             Vector<double> &solution)
+  {
+    VectorType distributed_solution;
+    solve(boundary_values, solver_control, distributed_solution);
+    solution.reinit(distributed_solution.size());
+    std::copy(distributed_solution.begin(), distributed_solution.end(), solution.begin());
+  }
+
+  /**
+   *  Memory used by the precomputed data of the operator in bytes.
+   */
+  virtual std::size_t memory_consumption() const = 0;
+};
+
+/**
+ *  Class for the matrix-free solution of the Poisson equation with FE_Q elements of degree fe_degree. The Laplace operator
+ *  is applied cell by cell with sum factorization on batches of cells that are processed together in SIMD lanes, so the
+ *  global matrix is never stored. The non-homogeneous Dirichlet values are lifted into the right hand side, the operator
+ *  itself only sees homogeneous constraints. The CG solver is preconditioned by a Chebyshev iteration around the inverse
+ *  diagonal of the operator, which only needs operator applications. All vectors are distributed vectors, so the same class
+ *  solves on a serial and on a parallel distributed triangulation.
+ */
+template <int dim, int fe_degree>
+class MatrixFreeLaplace : public MatrixFreeProblem<dim>
+{
+public:
+  void initialize(const DoFHandler<dim> &dof_handler,
+                  const Function<dim> *source = nullptr,
+                  const Function<dim> *coefficient = nullptr) override;
+  using MatrixFreeProblem<dim>::solve;
+  void solve(const std::map<types::global_dof_index, double> &boundary_values,
+             SolverControl &solver_control,
+             LinearAlgebra::distributed::Vector<double> &solution) override;
+  std::size_t memory_consumption() const override;
+
+private:
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  using LaplaceOperator = MatrixFreeOperators::LaplaceOperator<dim, fe_degree, fe_degree + 1, 1, VectorType>;
+
+  void assemble_rhs(const VectorType &lifting, VectorType &rhs) const;
+  std::shared_ptr<Table<2, VectorizedArray<double>>> tabulate(const Function<dim> &function) const;
+
+  AffineConstraints<double> constraints;                    //!< Hanging node and homogeneous boundary constraints
+  std::shared_ptr<MatrixFree<dim, double>> matrix_free;     //!< Precomputed geometry data of all cell batches
+  LaplaceOperator laplace_operator;                         //!< Matrix-free Laplace operator
+  std::shared_ptr<Table<2, VectorizedArray<double>>> source_values; //!< Source at the quadrature points of every cell batch, empty for f = 1
+};
+
+/**
+	 * Set up the constraints and the MatrixFree object of the given DoFHandler and compute the diagonal of the operator for the
+   * preconditioner.
+   *
+   * \param dof_handler DoFHandler with distributed degrees of freedom of an FE_Q element of degree fe_degree, on a serial or a
+   * parallel distributed triangulation.
+   * \param source Source term f, nullptr for the constant 1.
+   * \param coefficient Coefficient a of the operator, nullptr for the constant 1.
+ 	 *
+	 */
+template <int dim, int fe_degree>
+void MatrixFreeLaplace<dim, fe_degree>::initialize(const DoFHandler<dim> &dof_handler,
+                                                   const Function<dim> *source,
+                                                   const Function<dim> *coefficient)
+{
+  IndexSet locally_relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs(dof_handler, locally_relevant_dofs);
+  constraints.clear();
+  constraints.reinit(locally_relevant_dofs);
+  DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+  VectorTools::interpolate_boundary_values(dof_handler, 0, Functions::ZeroFunction<dim>(), constraints);
+  constraints.close();
+
+  typename MatrixFree<dim, double>::AdditionalData additional_data;
+  additional_data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::partition_color;
+  additional_data.mapping_update_flags = update_values | update_gradients | update_JxW_values | update_quadrature_points;
+
+  matrix_free = std::make_shared<MatrixFree<dim, double>>();
+  matrix_free->reinit(MappingQGeneric<dim>(1), dof_handler, constraints, QGauss<1>(fe_degree + 1), additional_data);
+
+  laplace_operator.clear();
+  laplace_operator.initialize(matrix_free);
+  if (coefficient)
+    laplace_operator.set_coefficient(tabulate(*coefficient));
+  laplace_operator.compute_diagonal();
+  source_values = source ? tabulate(*source) : nullptr;
+}
+
+/**
+	 * Evaluate a function at the quadrature points of all cell batches. The points of all filled lanes of a cell batch are
+   * collected and evaluated with one value_list() call, like the quadrature points of a cell in QuadratureValueCache, so a
+   * PointListFunction gets whole batches. The values are computed once per grid, the operator and the right hand side read
+   * them in every application.
+   *
+   * \param function Function to evaluate, e.g. the source or the coefficient.
+   * \return Table with one row per cell batch and one entry per quadrature point
+ 	 *
+	 */
+template <int dim, int fe_degree>
+std::shared_ptr<Table<2, VectorizedArray<double>>>
+MatrixFreeLaplace<dim, fe_degree>::tabulate(const Function<dim> &function) const
+{
+  FEEvaluation<dim, fe_degree> phi(*matrix_free);
+  auto values = std::make_shared<Table<2, VectorizedArray<double>>>(matrix_free->n_cell_batches(), phi.n_q_points);
+  std::vector<Point<dim>> points;
+  std::vector<double> point_values;
+  for (unsigned int cell = 0; cell < matrix_free->n_cell_batches(); ++cell)
+    {
+      phi.reinit(cell);
+      const unsigned int n_lanes = matrix_free->n_active_entries_per_cell_batch(cell);
+      points.resize(n_lanes * phi.n_q_points);
+      point_values.resize(points.size());
+      for (unsigned int q = 0; q < phi.n_q_points; ++q)
+        {
+          const Point<dim, VectorizedArray<double>> point_batch = phi.quadrature_point(q);
+          for (unsigned int lane = 0; lane < n_lanes; ++lane)
+            for (unsigned int d = 0; d < dim; ++d)
+              points[q * n_lanes + lane][d] = point_batch[d][lane];
+        }
+
+      function.value_list(points, point_values);
+      for (unsigned int q = 0; q < phi.n_q_points; ++q)
+        {
+          (*values)(cell, q) = 0.;
+          for (unsigned int lane = 0; lane < n_lanes; ++lane)
+            (*values)(cell, q)[lane] = point_values[q * n_lanes + lane];
+        }
+    }
+  return values;
+}
+
+/**
+	 * Compute the right hand side f - A g, where g is the lifting vector that holds the Dirichlet values on the boundary and zero
+   * in the interior. The operator is applied to the lifting vector without constraints, which gives the coupling of the boundary
+   * values to the interior degrees of freedom. With a coefficient the lifting is scaled by the coefficient like the operator.
+   *
+   * \param lifting Vector with the Dirichlet values on the boundary degrees of freedom.
+   * \param rhs Right hand side for the homogeneous problem.
+ 	 *
+	 */
+template <int dim, int fe_degree>
+void MatrixFreeLaplace<dim, fe_degree>::assemble_rhs(const VectorType &lifting, VectorType &rhs) const
+{
+  FEEvaluation<dim, fe_degree> phi(*matrix_free);
+  for (unsigned int cell = 0; cell < matrix_free->n_cell_batches(); ++cell)
+    {
+      phi.reinit(cell);
+      const VectorizedArray<double> *coefficient_values =
+        laplace_operator.get_coefficient() ? &(*laplace_operator.get_coefficient())(cell, 0) : nullptr;
+      phi.read_dof_values_plain(lifting);
+      phi.evaluate(EvaluationFlags::gradients);
+      for (unsigned int q = 0; q < phi.n_q_points; ++q)
+        {
+          phi.submit_value(source_values ? (*source_values)(cell, q)
+                                         : make_vectorized_array<double>(1.), q); // f(x_q)
+          phi.submit_gradient(coefficient_values ? -coefficient_values[q] * phi.get_gradient(q)
+                                                 : -phi.get_gradient(q), q); // -a(x_q) grad g(x_q)
+        }
+      phi.integrate(EvaluationFlags::values | EvaluationFlags::gradients);
+      phi.distribute_local_to_global(rhs);
+    }
+  rhs.compress(VectorOperation::add);
+}
+
+/**
+	 * Solve the homogeneous problem for the lifted right hand side with the Chebyshev preconditioned CG solver and add the boundary
+   * values to the result. On a parallel triangulation all vector operations and the CG solver communicate over the MPI communicator
+   * of the triangulation.
+   *
+   * \param boundary_values Dirichlet values of all boundary degrees of freedom.
+   * \param solver_control Stopping criteria of the CG solver, holds the number of iterations afterwards.
+   * \param solution Solution vector, initialized with the locally owned and ghost degrees of freedom of the MatrixFree object.
+ 	 *
+	 */
+template <int dim, int fe_degree>
+void MatrixFreeLaplace<dim, fe_degree>::solve(const std::map<types::global_dof_index, double> &boundary_values,
+                                              SolverControl &solver_control,
+                                              VectorType &solution)
+{
+  VectorType lifting, rhs;
+  matrix_free->initialize_dof_vector(lifting);
+  matrix_free->initialize_dof_vector(rhs);
+  matrix_free->initialize_dof_vector(solution);
+
+  /* Every process sets the boundary values of its own cells, including the ghost entries that are read by assemble_rhs() */
+  const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner = lifting.get_partitioner();
+  for (const auto &boundary_value : boundary_values)
+    if (partitioner->in_local_range(boundary_value.first) || partitioner->is_ghost_entry(boundary_value.first))
+      lifting(boundary_value.first) = boundary_value.second;
+  lifting.compress(VectorOperation::insert);
+  lifting.update_ghost_values();
+  assemble_rhs(lifting, rhs);
+
+  using Preconditioner = PreconditionChebyshev<LaplaceOperator, VectorType>;
+  typename Preconditioner::AdditionalData preconditioner_data;
+  preconditioner_data.degree = 5;
+  preconditioner_data.smoothing_range = 100.;
+  preconditioner_data.preconditioner = laplace_operator.get_matrix_diagonal_inverse();
+  Preconditioner preconditioner;
+  preconditioner.initialize(laplace_operator, preconditioner_data);
+
+  SolverCG<VectorType> solver(solver_control);
+  solver.solve(laplace_operator, solution, rhs, preconditioner);
+
+  constraints.distribute(solution);
+  solution += lifting;
+}
+
+/**
+	 * Memory used by the MatrixFree object, the diagonal of the operator and the tabulated functions in bytes.
+ 	 *
+	 */
+template <int dim, int fe_degree>
+std::size_t MatrixFreeLaplace<dim, fe_degree>::memory_consumption() const
+{
+  return matrix_free->memory_consumption() + laplace_operator.memory_consumption() +
+         (source_values ? source_values->memory_consumption() : 0);
+}
+
+/**
+	 * Create the matrix-free solver for the given polynomial degree. The degree has to be known at compile time for the sum
+   * factorization, so the supported degrees 1 to 3 are instantiated here.
+   *
+   * \param degree Degree of the FE_Q element.
+   * \return Matrix-free solver for the given degree
+ 	 *
+	 */
+template <int dim>
+std::unique_ptr<MatrixFreeProblem<dim>> create_matrix_free_problem(const unsigned int degree)
+{
+  switch (degree)
+    {
+      case 1:
+        return std::make_unique<MatrixFreeLaplace<dim, 1>>();
+      case 2:
+        return std::make_unique<MatrixFreeLaplace<dim, 2>>();
+      case 3:
+        return std::make_unique<MatrixFreeLaplace<dim, 3>>();
+      default:
+        AssertThrow(false, ExcMessage("The matrix-free solver supports shape function orders 1 to 3."));
+        return nullptr;
+    }
+}
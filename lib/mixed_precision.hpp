@@ -0,0 +1,160 @@
+/**
+ * \file mixed_precision.hpp
+ *
+ * Mixed precision solver with single precision CG iterations inside a double precision iterative refinement
+ */
+
+#pragma once
+
+#include "preconditioner.hpp"
+#include "progress.hpp"
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <string>
+
+using namespace dealii;
+
+/**
+ *  Solver that stores the system matrix and the preconditioner in single precision. CG on a sparse matrix is limited by
+ *  the memory bandwidth, so reading float instead of double entries halves the time of every iteration on large grids.
+ *  The accuracy is recovered by iterative refinement: the residual b - A x is computed with the double matrix, the float
+ *  CG solver reduces it by inner_reduction to get a correction, and the correction is added to the double solution. Every
+ *  refinement step gains about four digits, so the residual reaches the tolerance of the double CG solver after a few steps.
+ */
+template <int dim>
+class MixedPrecisionSolver
+{
+public:
+  MixedPrecisionSolver(PreconditionerType type);
+  void initialize(const SparseMatrix<double> &system_matrix, const DoFHandler<dim> &dof_handler,
+                  const Function<dim> *coefficient = nullptr);
+  void solve(const SparseMatrix<double> &system_matrix, Vector<double> &solution, const Vector<double> &rhs,
+             SolverControl &solver_control, const ProgressCallback &progress);
+  std::string name() const;
+  unsigned int refinement_steps() const;
+  std::size_t memory_consumption() const;
+
+private:
+  static constexpr double inner_reduction = 1e-4; //!< Reduction of the residual by the float CG solver in every refinement step
+
+  SparseMatrix<float> matrix;           //!< Single precision copy of the system matrix with applied boundary values
+  PoissonPreconditioner<dim, float> preconditioner; //!< Single precision preconditioner for the inner CG solver
+  unsigned int n_refinement_steps = 0;  //!< Number of refinement steps of the last solve
+};
+
+/**
+	 * Constructor for the MixedPrecisionSolver class
+	 *
+	 * \param type Preconditioner of the inner CG solver.
+	 * \return Constructed mixed precision solver object
+	 */
+template <int dim>
+MixedPrecisionSolver<dim>::MixedPrecisionSolver(PreconditionerType type)
+  : preconditioner(type)
+{}
+
+/**
+	 * Copy the system matrix to single precision and build the preconditioner for the copy. Like the double preconditioner, both stay
+   * valid for re-solves with changed boundary values.
+   *
+   * \param system_matrix System matrix with applied boundary values.
+   * \param dof_handler DoFHandler of the problem, the multigrid preconditioner needs distributed multilevel degrees of freedom.
+   * \param coefficient Coefficient of the Laplace operator for the multigrid level matrices, nullptr for the constant 1.
+ 	 *
+	 */
+template <int dim>
+void MixedPrecisionSolver<dim>::initialize(const SparseMatrix<double> &system_matrix, const DoFHandler<dim> &dof_handler,
+                                           const Function<dim> *coefficient)
+{
+  matrix.reinit(system_matrix.get_sparsity_pattern());
+  matrix.copy_from(system_matrix);
+  preconditioner.initialize(matrix, dof_handler, coefficient);
+}
+
+/**
+	 * Solve the system by iterative refinement. The solver control is checked with the double residual after every refinement step and
+   * counts the float CG iterations of all steps, so tolerance and maximum number of iterations mean the same as for the double CG
+   * solver. The inner solves report their iterations to the progress callback, which can cancel them.
+   *
+   * \param system_matrix System matrix with applied boundary values, the residual is computed with it.
+   * \param solution Initial guess with the boundary values, receives the solution.
+   * \param rhs Right hand side with applied boundary values.
+   * \param solver_control Tolerance and maximum number of iterations, receives the final residual and the total number of iterations.
+   * \param progress Progress callback of the solver options.
+ 	 *
+	 */
+template <int dim>
+void MixedPrecisionSolver<dim>::solve(const SparseMatrix<double> &system_matrix, Vector<double> &solution,
+                                      const Vector<double> &rhs, SolverControl &solver_control,
+                                      const ProgressCallback &progress)
+{
+  Vector<double> residual(rhs.size());
+  Vector<float> residual_float(rhs.size());
+  Vector<float> correction(rhs.size());
+  unsigned int n_iterations = 0;
+  n_refinement_steps = 0;
+
+  SolverControl::State state = SolverControl::iterate;
+  while ((state = solver_control.check(n_iterations, system_matrix.residual(residual, solution, rhs))) ==
+         SolverControl::iterate)
+    {
+      residual_float = residual;
+      correction = 0;
+      ProgressSolverControl inner_control(solver_control.max_steps() - n_iterations,
+                                          inner_reduction * solver_control.last_value(), progress);
+      SolverCG<Vector<float>> inner_solver(inner_control);
+      try
+        {
+          inner_solver.solve(matrix, correction, residual_float, preconditioner);
+        }
+      catch (const SolverControl::NoConvergence &)
+        {
+          /* The partial correction still reduces the residual, the outer check stops at the maximum number of iterations */
+        }
+      n_iterations += inner_control.last_step();
+      ++n_refinement_steps;
+
+      residual = correction;
+      solution += residual;
+    }
+  AssertThrow(state == SolverControl::success,
+              SolverControl::NoConvergence(solver_control.last_step(), solver_control.last_value()));
+}
+
+/**
+	 * Name of the inner preconditioner for the solver output.
+ 	 *
+	 */
+template <int dim>
+std::string MixedPrecisionSolver<dim>::name() const
+{
+  return "single precision " + preconditioner.name();
+}
+
+/**
+	 * Number of refinement steps of the last solve, each one is a float CG solve.
+ 	 *
+	 */
+template <int dim>
+unsigned int MixedPrecisionSolver<dim>::refinement_steps() const
+{
+  return n_refinement_steps;
+}
+
+/**
+	 * Memory used by the single precision matrix and preconditioner in bytes.
+ 	 *
+	 */
+template <int dim>
+std::size_t MixedPrecisionSolver<dim>::memory_consumption() const
+{
+  return matrix.memory_consumption() + preconditioner.memory_consumption();
+}
@@ -0,0 +1,120 @@
+/**
+ * \file nonlinear.hpp
+ *
+ * Carrier density term of the nonlinear Poisson-Boltzmann equation and options of its Newton solver
+ */
+
+#pragma once
+
+#include "assembly.hpp"
+
+#include <deal.II/base/work_stream.h>
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_values.h>
+
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/sparse_matrix.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace dealii;
+
+/**
+ *  Parameters of the Poisson-Boltzmann equation -div(a grad u) + n_i (exp(u / V_T) - exp(-u / V_T)) = f and of its Newton
+ *  solver. The electron and hole densities are n_i exp(u / V_T) and n_i exp(-u / V_T), the source f is the doping and the
+ *  coefficient a the permittivity of the Poisson problem. All quantities are scaled, e.g. u in units of the thermal voltage.
+ */
+struct NewtonOptions
+{
+  double thermal_voltage = 1.;          //!< Thermal voltage V_T
+  double intrinsic_density = 1.;        //!< Intrinsic carrier density n_i times the elementary charge
+  unsigned int max_newton_steps = 50;   //!< Maximum number of Newton steps
+  double newton_tolerance = 1e-10;      //!< Norm of the nonlinear residual below which the Newton iteration has converged
+  double linear_reduction = 1e-3;       //!< Reduction of the residual by the inner CG solver in every Newton step
+  double jacobian_reuse_ratio = 0.1;    //!< The Jacobian is kept as long as a full step reduces the residual by this factor
+  unsigned int max_line_search_steps = 10; //!< Maximum number of step length halvings of the backtracking line search
+};
+
+/**
+	 * Assemble the carrier density term of the Poisson-Boltzmann equation for the current potential, the vector
+   * int n_i (exp(u / V_T) - exp(-u / V_T)) phi_i dx and optionally its derivative int n_i / V_T (exp(u / V_T) + exp(-u / V_T)) phi_i phi_j dx,
+   * which is added to the stiffness matrix to get the Jacobian of the Newton iteration. The cells are assembled in parallel with
+   * WorkStream like the Laplace system, the hanging node constraints are resolved by the copier.
+   *
+   * \param dof_handler DoFHandler with distributed degrees of freedom.
+   * \param constraints Hanging node constraints of the grid.
+   * \param potential Current potential u, satisfying the constraints.
+   * \param newton_options Thermal voltage and intrinsic density.
+   * \param term Vector of size n_dofs that receives the carrier density term.
+   * \param derivative Matrix with the sparsity pattern of the problem that receives the derivative, nullptr if only the term is needed.
+ 	 *
+	 */
+template <int dim>
+void assemble_carrier_term(const DoFHandler<dim> &dof_handler,
+                           const AffineConstraints<double> &constraints,
+                           const Vector<double> &potential,
+                           const NewtonOptions &newton_options,
+                           Vector<double> &term,
+                           SparseMatrix<double> *derivative)
+{
+  const FiniteElement<dim> &fe = dof_handler.get_fe();
+  const QGauss<dim> quadrature_formula(fe.degree + 1);
+  const double density = newton_options.intrinsic_density;
+  const double thermal_voltage = newton_options.thermal_voltage;
+
+  term = 0;
+  if (derivative)
+    *derivative = 0;
+
+  WorkStream::run(dof_handler.begin_active(),
+                  dof_handler.end(),
+                  [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+                      AssemblyScratchData<dim> &scratch_data,
+                      AssemblyCopyData &copy_data) {
+                    FEValues<dim> &fe_values = scratch_data.fe_values;
+                    const unsigned int dofs_per_cell = fe_values.get_fe().n_dofs_per_cell();
+                    copy_data.cell_matrix.reinit(derivative ? dofs_per_cell : 0, derivative ? dofs_per_cell : 0);
+                    copy_data.cell_rhs.reinit(dofs_per_cell);
+                    copy_data.local_dof_indices.resize(dofs_per_cell);
+
+                    fe_values.reinit(cell);
+                    std::vector<double> potential_values(fe_values.n_quadrature_points);
+                    fe_values.get_function_values(potential, potential_values);
+                    for (const unsigned int q_index : fe_values.quadrature_point_indices())
+                      {
+                        const double electrons = density * std::exp(potential_values[q_index] / thermal_voltage);
+                        const double holes = density * std::exp(-potential_values[q_index] / thermal_voltage);
+                        for (const unsigned int i : fe_values.dof_indices())
+                          {
+                            copy_data.cell_rhs(i) += ((electrons - holes) *                // n(x_q) - p(x_q)
+                                                      fe_values.shape_value(i, q_index) * // phi_i(x_q)
+                                                      fe_values.JxW(q_index));            // dx
+                            if (derivative)
+                              for (const unsigned int j : fe_values.dof_indices())
+                                copy_data.cell_matrix(i, j) +=
+                                  ((electrons + holes) / thermal_voltage * // d(n - p)/du (x_q)
+                                   fe_values.shape_value(i, q_index) *    // phi_i(x_q)
+                                   fe_values.shape_value(j, q_index) *    // phi_j(x_q)
+                                   fe_values.JxW(q_index));               // dx
+                          }
+                      }
+                    cell->get_dof_indices(copy_data.local_dof_indices);
+                  },
+                  [&constraints, &term, derivative](const AssemblyCopyData &copy_data) {
+                    if (derivative)
+                      constraints.distribute_local_to_global(copy_data.cell_matrix,
+                                                             copy_data.cell_rhs,
+                                                             copy_data.local_dof_indices,
+                                                             *derivative,
+                                                             term);
+                    else
+                      constraints.distribute_local_to_global(copy_data.cell_rhs, copy_data.local_dof_indices, term);
+                  },
+                  AssemblyScratchData<dim>(fe, quadrature_formula),
+                  AssemblyCopyData());
+}
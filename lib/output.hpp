@@ -0,0 +1,101 @@
+/**
+ * \file output.hpp
+ *
+ * Output of the solution in the formats selected by the solver options
+ */
+
+#pragma once
+
+#include "solver_options.hpp"
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/exceptions.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/data_out.h>
+
+#include <fstream>
+#include <string>
+
+using namespace dealii;
+
+/**
+	 * Write the solution to the output directory in the format of the solver options. Legacy VTK is written as ASCII, VTU is written
+   * as zlib compressed binary, PVTU writes a VTU piece together with the parallel record that references it and HDF5 writes the
+   * heavy data to an .h5 file that is described by an XDMF file.
+   *
+   * \param dof_handler DoFHandler of the problem.
+   * \param solution Solution vector.
+   * \param options Solver options with the output format, directory and file name.
+   * \param default_name File name without extension, used if the solver options do not set one.
+   * \param run Number of the run, appended to the file name if numbered output is selected.
+   * \return Name of the written file, for PVTU the parallel record and for HDF5 the XDMF file
+ 	 *
+	 */
+template <int dim>
+std::string write_solution(const DoFHandler<dim> &dof_handler,
+                           const Vector<double> &solution,
+                           const SolverOptions &options,
+                           const std::string &default_name,
+                           const unsigned int run)
+{
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler(dof_handler);
+  data_out.add_data_vector(solution, "solution");
+  data_out.build_patches();
+
+  std::string name = options.output_name.empty() ? default_name : options.output_name;
+  if (options.numbered_output && options.output_format != OutputFormat::pvtu)
+    name += "-" + Utilities::int_to_string(run, 4);
+
+  switch (options.output_format)
+    {
+      case OutputFormat::vtk:
+        {
+          std::ofstream output(options.output_directory + name + ".vtk");
+          data_out.write_vtk(output);
+          return options.output_directory + name + ".vtk";
+        }
+
+      case OutputFormat::vtu:
+        {
+          DataOutBase::VtkFlags vtk_flags;
+          vtk_flags.compression_level = DataOutBase::VtkFlags::best_speed;
+          data_out.set_flags(vtk_flags);
+          std::ofstream output(options.output_directory + name + ".vtu");
+          data_out.write_vtu(output);
+          return options.output_directory + name + ".vtu";
+        }
+
+      case OutputFormat::pvtu:
+        {
+          DataOutBase::VtkFlags vtk_flags;
+          vtk_flags.compression_level = DataOutBase::VtkFlags::best_speed;
+          data_out.set_flags(vtk_flags);
+          /* The record always carries a counter, it is the run number for numbered output and 0 otherwise */
+          return options.output_directory +
+                 data_out.write_vtu_with_pvtu_record(options.output_directory, name,
+                                                     options.numbered_output ? run : 0,
+                                                     MPI_COMM_SELF, 4);
+        }
+
+      case OutputFormat::hdf5:
+        {
+#ifdef DEAL_II_WITH_HDF5
+          DataOutBase::DataOutFilter data_filter(DataOutBase::DataOutFilterFlags(true, true));
+          data_out.write_filtered_data(data_filter);
+          data_out.write_hdf5_parallel(data_filter, options.output_directory + name + ".h5", MPI_COMM_SELF);
+          const XDMFEntry entry = data_out.create_xdmf_entry(data_filter, name + ".h5", static_cast<double>(run), MPI_COMM_SELF);
+          data_out.write_xdmf_file({entry}, options.output_directory + name + ".xdmf", MPI_COMM_SELF);
+          return options.output_directory + name + ".xdmf";
+#else
+          AssertThrow(false, ExcNeedsHDF5());
+#endif
+        }
+    }
+  return "";
+}
@@ -29,12 +29,29 @@
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/sparse_matrix.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/affine_constraints.h>
 #include <deal.II/lac/solver_cg.h>
 #include <deal.II/lac/precondition.h>
+#include <deal.II/lac/sparse_direct.h>
 
 
 #include <deal.II/numerics/data_out.h>
 #include <deal.II/base/point.h>
+#include <deal.II/base/timer.h>
+
+#include "solver_options.hpp"
+#include "preconditioner.hpp"
+#include "mixed_precision.hpp"
+#include "assembly.hpp"
+#include "renumbering.hpp"
+#include "matrix_free.hpp"
+#include "solution_mesh.hpp"
+#include "output.hpp"
+#include "adaptivity.hpp"
+#include "statistics.hpp"
+#include "nonlinear.hpp"
+#include "initial_guess.hpp"
+#include "geometry.hpp"
 
 #include <iostream>
 #include <fstream>
@@ -67,104 +84,116 @@ double BoundaryValues<dim>::value(const Point<dim> &p,
 }
 
 /**
- *  Class for calculating the poisson problem on a radial domain. 
+ *  Class for calculating the poisson problem in 2D and 3D on the domain of a geometry policy, see geometry.hpp. The policy only
+ *  creates the coarse grid, the setup, assembly, solve and output are shared by all geometries.
  */
-class Radial_Poisson
+template <int dim, class Geometry>
+class PoissonProblem
 {
 public:
-  Radial_Poisson(std::vector<double> _dimensions, int _refinement, int _shape_function, int _bc);
-  void run(int _bc);
-  void run();
+  PoissonProblem(const Geometry &_geometry, int _refinement, int _shape_function, int _bc, bool _homogeneous, SolverOptions _options = SolverOptions());
+  SolveStatistics run(int _bc);
+  std::vector<Vector<double>> run_sweep(const std::vector<double> &boundary_values);
+  SolveStatistics run();
+  SolveStatistics run_nonlinear(const NewtonOptions &newton_options = NewtonOptions());
+  void set_homogeneous(bool _homogeneous);
+  void set_source(const std::shared_ptr<const Function<dim>> &_source);
+  void set_coefficient(const std::shared_ptr<const Function<dim>> &_coefficient);
+  void set_boundary_function(const std::shared_ptr<const Function<dim>> &_boundary_function);
+  std::shared_ptr<SolutionMesh> solution_mesh() const;
+  const std::string &last_output_file() const;
+  types::global_dof_index n_dofs() const;
+  std::size_t memory_consumption() const;
 private:
   void make_grid();
   void setup_system();
   void assemble_system();
+  void interpolate_boundary_values(std::map<types::global_dof_index, double> &boundary_values) const;
+  void apply_boundary_values();
+  bool use_direct_solver() const;
   void solve();
-  void output_results() const;
-
-  std::vector<double> dimensions;
-  int refinement;                       //!< Refinement of triangulation
-  int bc;                               //!< Constant boundary condition
-  
-
-  Triangulation<2> triangulation;       //!< Collection of cells that jointly cover the domain
-  FE_Q<2>          fe;                  //!< Implementation of scalar Lagrange finite element  that yields the finite element space.
-  DoFHandler<2>    dof_handler;         //!< Global numbering of degrees of freedom
-  SparsityPattern      sparsity_pattern;  //!< Class stores sparsity pattern in the CSR format
-  SparseMatrix<double> system_matrix;   //!< Sparse matrix to store entry values in the locations denoted by SparsityPattern
-  Vector<double> solution;              //!< Vector containing the solution 
-  Vector<double> system_rhs;            //!< Vector containing the right hand side of the system
-};
-
-
-
-
-/**
- *  Class for calculating the poisson problem on a hyper rectangular domain in 2D and 3D.
- */
-template <int dim>
-class Poisson
-{
-public:
-  Poisson(std::vector<int> _dimensions, int _refinement, int _shape_function, int _bc, bool _homogeneous);
-  void run(int _bc);
-  void run();
-private:
-  void make_grid();
-  void setup_system();
-  void assemble_system();
-  void solve();
-  void output_results() const;
+  void newton_solve(const NewtonOptions &newton_options);
+  double nonlinear_residual(const Vector<double> &potential, const NewtonOptions &newton_options,
+                            const std::map<types::global_dof_index, double> &boundary_values,
+                            Vector<double> &residual, SparseMatrix<double> *carrier_matrix) const;
+  bool refine_grid(unsigned int cycle);
+  void output_results();
+  SolveStatistics finish_run();
 
   int refinement;                       //!< Refinement of triangulation
   int bc;                               //!< Constant boundary condition
   bool homogeneous;                     //!< If false, non-homogeneous BC are applied
+  SolverOptions options;                //!< Options for the linear solver and the output
+  bool assembled = false;               //!< True once the stiffness matrix has been assembled on the current grid
+  unsigned int n_runs = 0;              //!< Number of finished runs, used for numbered output files
+  std::string output_file;              //!< Name of the last written output file
+  TimerOutput computing_timer;          //!< Wall time of the phases of the current run
+  SolveStatistics statistics;           //!< Statistics of the current run
 
 
   Triangulation<dim> triangulation;     //!< Collection of cells that jointly cover the domain
   FE_Q<dim>          fe;                //!< Implementation of scalar Lagrange finite element  that yields the finite element space.
-  Point<dim> point;                     //!< Diagonally opposite corner point of hyper rectangle (p1 is origin)
+  Geometry geometry;                    //!< Creates the coarse grid, see geometry.hpp
   DoFHandler<dim>    dof_handler;       //!< Global numbering of degrees of freedom
   SparsityPattern      sparsity_pattern;  //!< Class stores sparsity pattern in the CSR format
   SparseMatrix<double> system_matrix;   //!< Sparse matrix to store entry values in the locations denoted by SparsityPattern
+  SparseMatrix<double> assembled_matrix; //!< Stiffness matrix before the boundary values are applied
   Vector<double> solution;              //!< Vector containing the solution 
   Vector<double> system_rhs;            //!< Vector containing the right hand side of the system
+  Vector<double> assembled_rhs;         //!< Right hand side before the boundary values are applied
+  PoissonPreconditioner<dim> preconditioner; //!< Preconditioner for the CG solver, built once per assembled system
+  MixedPrecisionSolver<dim> mixed_precision_solver; //!< Single precision system and preconditioner, replaces the CG solver if selected
+  SparseDirectUMFPACK direct_solver;    //!< LU factorization of the system matrix, replaces the CG solver if selected
+  bool direct = false;                  //!< True if the system of the current grid is solved with the LU factorization
+  AffineConstraints<double> constraints; //!< Hanging node constraints of the locally refined grid
+  std::unique_ptr<MatrixFreeProblem<dim>> matrix_free_problem; //!< Matrix-free solver, replaces the system matrix if selected
+  QuadratureValueCache<dim> source;     //!< Source term f with its values at the quadrature points, f = 1 if not set
+  QuadratureValueCache<dim> coefficient; //!< Coefficient a with its values at the quadrature points, a = 1 if not set
+  SolutionHistory solution_history;     //!< Previous solutions on the current grid for the initial guess of re-solves
+  bool warm_start = false;              //!< True if the next solve starts from previous solutions
+  unsigned int cold_cg_iterations = 0;  //!< CG iterations of the cold solve after the last assembly
+  std::shared_ptr<const Function<dim>> boundary_function = std::make_shared<BoundaryValues<dim>>(); //!< Non-homogeneous Dirichlet values
 };
 
 /**
-	 * Constructor for Poisson class
+	 * Constructor for PoissonProblem class
 	 *
-	 * \param _dimensions Dimensions of hyper rectangle defined by two points: origin and point with dimensions coordinates.
+	 * \param _geometry Geometry policy that creates the coarse grid, e.g. HyperRectangle, HyperShell or ImportedMesh.
    * \param _refinement Refine all cells _refinement times. In each iteration, loops over all cells and refines each cell uniformly into  2^{dim}  children. 
-   * The end result is the number of cells increased by a factor  2^{dim x _refinement} 
+   * The end result is the number of cells increased by a factor  2^{dim x _refinement}, the geometry may refine some cells further 
    * \param _shape_function Degree of continuous, piecewise polynomials for finite element space of Lagrangian finite elements.
    * \param _bc Constant Dirichlet boundary values 
+   * \param _homogeneous If true, the constant boundary values are applied, otherwise the ones given by BoundaryValues
+   * \param _options Options for the linear solver, e.g. the preconditioner
 	 * \return Constructed poisson class object
 	 */
-template <int dim>
-Poisson<dim>::Poisson(std::vector<int> _dimensions, 
-                      int _refinement, 
-                      int _shape_function, int _bc, bool _homogeneous) 
-  : refinement(_refinement), bc(_bc), homogeneous(_homogeneous), fe(_shape_function), dof_handler(triangulation)
+template <int dim, class Geometry>
+PoissonProblem<dim, Geometry>::PoissonProblem(const Geometry &_geometry, 
+                                              int _refinement, 
+                                              int _shape_function, int _bc, bool _homogeneous,
+                                              SolverOptions _options) 
+  : refinement(_refinement), bc(_bc), homogeneous(_homogeneous), options(_options),
+    computing_timer(std::cout, TimerOutput::never, TimerOutput::wall_times), fe(_shape_function), geometry(_geometry),
+    dof_handler(triangulation), preconditioner(_options.preconditioner), mixed_precision_solver(_options.preconditioner)
 {
-  for(int i = 0; i < dim; i++){
-    point[i] = _dimensions[i];
-  }
   make_grid();
 }
 
 /**
-	 * Function to create a hyper reactangular grid from the given coordinates and the origin. The triangulation is refined refinement times to yield a triangulation
-   * with 2^{dim x refinement} cells. 
+	 * Function to create the grid of the geometry policy. The coarse grid is refined refinement times to yield a triangulation
+   * with 2^{dim x refinement} times the coarse cells, see create_grid() of the geometry. 
  	 *
 	 * 
 	 */
-template <int dim>
-void Poisson<dim>::make_grid()
+template <int dim, class Geometry>
+void PoissonProblem<dim, Geometry>::make_grid()
 {
-  Point<dim> origin;
-  GridGenerator::hyper_rectangle(triangulation, origin, point, false);
-  triangulation.refine_global(refinement);
+  report_progress(options.progress, SolvePhase::grid);
+  TimerOutput::Scope timer_section(computing_timer, Sections::grid);
+  /* The multigrid hierarchy of a locally refined grid needs at most one level difference between cells sharing a vertex */
+  if (options.preconditioner == PreconditionerType::multigrid)
+    triangulation.set_mesh_smoothing(Triangulation<dim>::limit_level_difference_at_vertices);
+  geometry.create_grid(triangulation, refinement);
   std::cout << "   Number of active cells: " << triangulation.n_active_cells()
             << std::endl
             << "   Total number of cells: " << triangulation.n_cells()
@@ -173,141 +202,692 @@ void Poisson<dim>::make_grid()
 
 /**
 	 * Enumerate all degrees of freedom and set up matrix and vector objects to hold the system data. The number of degrees of freedom depends on the 
-   * polynomial degree of the finite elements. 
+   * polynomial degree of the finite elements. The degrees of freedom are renumbered as selected in the solver options before the sparsity
+   * pattern is built, see renumber_dofs(). 
  	 * 
 	 */
-template <int dim>
-void Poisson<dim>::setup_system()
+template <int dim, class Geometry>
+void PoissonProblem<dim, Geometry>::setup_system()
 {
+  report_progress(options.progress, SolvePhase::dofs);
+  TimerOutput::Scope timer_section(computing_timer, Sections::setup);
   dof_handler.distribute_dofs(fe);
+  renumber_dofs(dof_handler, options.renumbering);
   std::cout << "   Number of degrees of freedom: " << dof_handler.n_dofs()
             << std::endl;
+  solution.reinit(dof_handler.n_dofs());
+  solution_history.clear();
+  warm_start = false;
+  if (options.matrix_free)
+    return;
+
+  if (options.preconditioner == PreconditionerType::multigrid)
+    dof_handler.distribute_mg_dofs();
+  constraints.clear();
+  DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+  constraints.close();
   DynamicSparsityPattern dsp(dof_handler.n_dofs());
-  DoFTools::make_sparsity_pattern(dof_handler, dsp);
+  DoFTools::make_sparsity_pattern(dof_handler, dsp, constraints, false);
   sparsity_pattern.copy_from(dsp);
   system_matrix.reinit(sparsity_pattern);
-  solution.reinit(dof_handler.n_dofs());
+  assembled_matrix.reinit(sparsity_pattern);
   system_rhs.reinit(dof_handler.n_dofs());
+  assembled_rhs.reinit(dof_handler.n_dofs());
 }
 
 /**
-	 * Compute the entries of the matrix and right hand side that form the linear system from which the solutio is computed. 
+	 * Compute the entries of the matrix and right hand side that form the linear system from which the solutio is computed. The cells are
+   * assembled in parallel by assemble_laplace_system(), the number of threads is set by the solver options. Afterwards the system matrix
+   * is factorized if the direct solver is selected, otherwise the preconditioner is built. Both only depend on the grid, so re-solves with
+   * new boundary values reuse them. 
  	 * 
 	 */
-template <int dim>
-void Poisson<dim>::assemble_system()
+template <int dim, class Geometry>
+void PoissonProblem<dim, Geometry>::assemble_system()
 {
-    
-    QGauss<dim> quadrature_formula(fe.degree + 1);
-    FEValues<dim> fe_values(fe, quadrature_formula, update_values | update_gradients | update_JxW_values);
-    const unsigned int dofs_per_cell = fe.n_dofs_per_cell();
+    report_progress(options.progress, SolvePhase::assembly);
+    TimerOutput::Scope timer_section(computing_timer, Sections::assembly);
+    direct = use_direct_solver();
 
-    FullMatrix<double> cell_matrix(dofs_per_cell, dofs_per_cell);
-    Vector<double> cell_rhs(dofs_per_cell);
+    if (options.matrix_free)
+      {
+        matrix_free_problem = create_matrix_free_problem<dim>(fe.degree);
+        matrix_free_problem->initialize(dof_handler, source.get_function(), coefficient.get_function());
+        assembled = true;
+        return;
+      }
 
-    std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
+    assemble_laplace_system(dof_handler, constraints, assembled_matrix, assembled_rhs, source, coefficient,
+                            options.assembly_threads, options.specialized_assembly, options.reuse_congruent_cells);
 
-    for (const auto &cell : dof_handler.active_cell_iterators())
-    {
-        fe_values.reinit(cell);
-        cell_matrix = 0;
-        cell_rhs    = 0;
-        for (const unsigned int q_index : fe_values.quadrature_point_indices())
-        {
-            for (const unsigned int i : fe_values.dof_indices())
-                for (const unsigned int j : fe_values.dof_indices())
-                cell_matrix(i, j) +=
-                    (fe_values.shape_grad(i, q_index) * // grad phi_i(x_q)
-                    fe_values.shape_grad(j, q_index) * // grad phi_j(x_q)
-                    fe_values.JxW(q_index));           // dx
-            for (const unsigned int i : fe_values.dof_indices())
-                cell_rhs(i) += (fe_values.shape_value(i, q_index) * // phi_i(x_q)
-                                1. *                                // f(x_q)
-                                fe_values.JxW(q_index));            // dx
-        }
-        cell->get_dof_indices(local_dof_indices);
+    system_matrix.copy_from(assembled_matrix);
+    system_rhs = assembled_rhs;
 
-        for (const unsigned int i : fe_values.dof_indices())
-            for (const unsigned int j : fe_values.dof_indices())
-                system_matrix.add(local_dof_indices[i], local_dof_indices[j],cell_matrix(i, j));
+    std::map<types::global_dof_index, double> boundary_values;
+    interpolate_boundary_values(boundary_values);
+    MatrixTools::apply_boundary_values(boundary_values,system_matrix,solution,system_rhs);
 
-        for (const unsigned int i : fe_values.dof_indices())
-            system_rhs(local_dof_indices[i]) += cell_rhs(i);
-    }
+    if (direct)
+      direct_solver.initialize(system_matrix);
+    else
+      {
+        direct_solver.clear();
+        if (options.mixed_precision)
+          mixed_precision_solver.initialize(system_matrix, dof_handler, coefficient.get_function());
+        else
+          preconditioner.initialize(system_matrix, dof_handler, coefficient.get_function());
+      }
+    solution_history.clear();
+    warm_start = false;
+    assembled = true;
+}
 
-    std::map<types::global_dof_index, double> boundary_values;
+/**
+	 * Collect the Dirichlet values of all boundary degrees of freedom, either the constant bc or the boundary function, by default BoundaryValues.
+ 	 * 
+	 */
+template <int dim, class Geometry>
+void PoissonProblem<dim, Geometry>::interpolate_boundary_values(std::map<types::global_dof_index, double> &boundary_values) const
+{
+  if(homogeneous)
+    VectorTools::interpolate_boundary_values(dof_handler,0,Functions::ConstantFunction<dim>(bc),boundary_values);
 
-    if(homogeneous)
-      VectorTools::interpolate_boundary_values(dof_handler,0,Functions::ConstantFunction<dim>(bc),boundary_values);
+  else  
+    VectorTools::interpolate_boundary_values(dof_handler,0,*boundary_function,boundary_values);
+}
 
-    else  
-      VectorTools::interpolate_boundary_values(dof_handler,0,BoundaryValues<dim>(),boundary_values);
+/**
+	 * Apply new boundary values without assembling the system again. Eliminating the boundary rows and columns does not depend on the boundary 
+   * values, so system_matrix stays valid and only the right hand side has to be rebuilt: the boundary values are lifted into the solution vector,
+   * their coupling to the interior is subtracted using the unconstrained matrix and the boundary rows are set to diagonal times value, which gives
+   * the same system as MatrixTools::apply_boundary_values. The CG solver starts from the previous solutions on the grid as selected in
+   * the solver options, see SolutionHistory, which saves most iterations in sweeps that change the boundary values in small steps. 
+ 	 * 
+	 */
+template <int dim, class Geometry>
+void PoissonProblem<dim, Geometry>::apply_boundary_values()
+{
+  report_progress(options.progress, SolvePhase::assembly);
+  TimerOutput::Scope timer_section(computing_timer, Sections::assembly);
 
-    MatrixTools::apply_boundary_values(boundary_values,system_matrix,solution,system_rhs);
+  /* The matrix-free solver lifts the boundary values itself in solve() */
+  if (options.matrix_free)
+    return;
 
+  std::map<types::global_dof_index, double> boundary_values;
+  interpolate_boundary_values(boundary_values);
+
+  Vector<double> lifting(dof_handler.n_dofs());
+  for (const auto &boundary_value : boundary_values)
+    lifting(boundary_value.first) = boundary_value.second;
+
+  assembled_matrix.vmult(system_rhs, lifting);
+  system_rhs.sadd(-1., assembled_rhs);
+
+  for (const auto &boundary_value : boundary_values)
+    system_rhs(boundary_value.first) = system_matrix.diag_element(boundary_value.first) * boundary_value.second;
+
+  /* The constrained entries of the condensed system are zero, the boundary entries hold the new values */
+  warm_start = solution_history.initial_guess(bc, options.initial_guess, solution);
+  if (!warm_start)
+    solution = 0;
+  constraints.set_zero(solution);
+  for (const auto &boundary_value : boundary_values)
+    solution(boundary_value.first) = boundary_value.second;
 }
 
 /**
-	 * Solve the discretized equation. The Conjugate Gradients algorithm is used as a solver. The stopping criteria is either 1000 iterations or a residual below
-   * 1e-12. The identity matrix is used as a preconditioner for the solver. 
+	 * Decide whether the system of the current grid is solved with the LU factorization of UMFPACK instead of CG. The factorization
+   * of a 2D system of moderate size costs about as much as a few CG solves, but every further solve for new boundary values is only a
+   * forward and backward substitution. The fill-in of 3D systems grows much faster, so the automatic selection only factorizes 2D
+   * systems up to the number of degrees of freedom given in the solver options.
+   * 
+   * \return True if the direct solver is used
  	 * 
 	 */
-template <int dim>
-void Poisson<dim>::solve()
+template <int dim, class Geometry>
+bool PoissonProblem<dim, Geometry>::use_direct_solver() const
 {
-  SolverControl            solver_control(1000, 1e-12);
-  SolverCG<Vector<double>> solver(solver_control);
-  solver.solve(system_matrix, solution, system_rhs, PreconditionIdentity());
+  AssertThrow(!options.matrix_free || options.linear_solver != LinearSolverType::direct,
+              ExcMessage("The direct solver needs the assembled system matrix."));
+#ifdef DEAL_II_WITH_UMFPACK
+  switch (options.linear_solver)
+    {
+      case LinearSolverType::direct:
+        return true;
+      case LinearSolverType::automatic:
+        return !options.matrix_free && dim == 2 && dof_handler.n_dofs() <= options.direct_solver_max_dofs;
+      default:
+        return false;
+    }
+#else
+  AssertThrow(options.linear_solver != LinearSolverType::direct, ExcMessage("The direct solver needs deal.II with UMFPACK."));
+  return false;
+#endif
+}
+
+/**
+	 * Solve the discretized equation. The Conjugate Gradients algorithm is used as a solver. The stopping criteria is either the maximum number of 
+   * iterations or a residual below the tolerance of the solver options. The preconditioner is selected by the solver options, the geometric
+   * multigrid preconditioner keeps the number of iterations independent of the refinement level. In matrix-free mode the operator
+   * is applied without a matrix and the CG solver is preconditioned by a Chebyshev iteration around its diagonal. In mixed precision mode
+   * the CG iterations run on single precision copies of the matrix and the preconditioner inside a double precision iterative refinement,
+   * see MixedPrecisionSolver, which reaches the same tolerance. With the direct solver the factorization of the last assembly is applied
+   * to the right hand side. 
+ 	 * 
+	 */
+template <int dim, class Geometry>
+void PoissonProblem<dim, Geometry>::solve()
+{
+  TimerOutput::Scope timer_section(computing_timer, Sections::solve);
+  if (direct)
+    {
+      report_progress(options.progress, SolvePhase::solve);
+      direct_solver.vmult(solution, system_rhs);
+      Vector<double> residual(dof_handler.n_dofs());
+      statistics.residual = system_matrix.residual(residual, solution, system_rhs);
+      constraints.distribute(solution);
+      std::cout << "   Solved with the UMFPACK factorization of the system matrix (residual " 
+                << statistics.residual << ")." << std::endl;
+      statistics.cg_iterations = 0;
+      statistics.warm_start = false;
+      statistics.saved_cg_iterations = 0;
+      statistics.newton_steps = 0;
+      statistics.jacobian_updates = 0;
+      return;
+    }
+
+  const unsigned int max_iterations = options.max_iterations > 0 ? options.max_iterations 
+                                                                 : std::max<unsigned int>(1000, dof_handler.n_dofs());
+  ProgressSolverControl    solver_control(max_iterations, options.tolerance, options.progress);
+  if (options.matrix_free)
+    {
+      std::map<types::global_dof_index, double> boundary_values;
+      interpolate_boundary_values(boundary_values);
+      matrix_free_problem->solve(boundary_values, solver_control, solution);
+    }
+  else if (options.mixed_precision)
+    {
+      mixed_precision_solver.solve(system_matrix, solution, system_rhs, solver_control, options.progress);
+      constraints.distribute(solution);
+      solution_history.add(solution, bc);
+    }
+  else
+    {
+      SolverCG<Vector<double>> solver(solver_control);
+      solver.solve(system_matrix, solution, system_rhs, preconditioner);
+      constraints.distribute(solution);
+      solution_history.add(solution, bc);
+    }
   std::cout << "   " << solver_control.last_step()
-            << " CG iterations needed to obtain convergence." << std::endl;
+            << " CG iterations with " << (options.matrix_free ? "matrix-free Chebyshev" 
+                                          : options.mixed_precision ? mixed_precision_solver.name() : preconditioner.name()) 
+            << " preconditioner needed to obtain convergence (residual " 
+            << solver_control.last_value() << ")." << std::endl;
+  if (options.mixed_precision && !options.matrix_free)
+    std::cout << "   " << mixed_precision_solver.refinement_steps() << " iterative refinement steps in double precision." << std::endl;
+  statistics.cg_iterations = solver_control.last_step();
+  statistics.residual = solver_control.last_value();
+  statistics.warm_start = warm_start;
+  if (warm_start)
+    {
+      statistics.saved_cg_iterations = static_cast<int>(cold_cg_iterations) - static_cast<int>(solver_control.last_step());
+      std::cout << "   Warm start saved " << statistics.saved_cg_iterations << " of " << cold_cg_iterations
+                << " CG iterations of the cold start." << std::endl;
+    }
+  else
+    {
+      cold_cg_iterations = solver_control.last_step();
+      statistics.saved_cg_iterations = 0;
+    }
+  statistics.newton_steps = 0;
+  statistics.jacobian_updates = 0;
 }
 
 /**
-	 * Finally, the results are written to a file. The format is VTK. 
+	 * Compute the residual A u + n(u) - p(u) - b of the Poisson-Boltzmann equation, where A and b are the assembled stiffness matrix and
+   * right hand side. The assembled matrix is condensed with the hanging node constraints, so it is applied to the potential with zeroed
+   * constrained entries, the carrier term is evaluated with the complete potential. The boundary entries are zero, since the potential
+   * already holds the Dirichlet values. 
+   * 
+   * \param potential Potential u, satisfying the boundary values and the hanging node constraints.
+   * \param newton_options Parameters of the carrier densities.
+   * \param boundary_values Dirichlet values of all boundary degrees of freedom.
+   * \param residual Residual of the equation.
+   * \param carrier_matrix Matrix that receives the derivative of the carrier term, nullptr if only the residual is needed.
+   * \return l2 norm of the residual
  	 * 
 	 */
-template <int dim>
-void Poisson<dim>::output_results() const
+template <int dim, class Geometry>
+double PoissonProblem<dim, Geometry>::nonlinear_residual(const Vector<double> &potential, const NewtonOptions &newton_options,
+                                        const std::map<types::global_dof_index, double> &boundary_values,
+                                        Vector<double> &residual, SparseMatrix<double> *carrier_matrix) const
+{
+  Vector<double> carrier_term(dof_handler.n_dofs());
+  assemble_carrier_term(dof_handler, constraints, potential, newton_options, carrier_term, carrier_matrix);
+
+  Vector<double> condensed_potential(potential);
+  constraints.set_zero(condensed_potential);
+  assembled_matrix.vmult(residual, condensed_potential);
+  residual -= assembled_rhs;
+  residual += carrier_term;
+  for (const auto &boundary_value : boundary_values)
+    residual(boundary_value.first) = 0;
+  return residual.l2_norm();
+}
+
+/**
+	 * Solve the Poisson-Boltzmann equation with Newton's method. The Jacobian is the assembled stiffness matrix plus the derivative of the
+   * carrier term, so only the carrier term is assembled in every step, the grid, the sparsity pattern and the stiffness matrix are the
+   * ones of the linear problem. The Jacobian and its preconditioner are kept as long as a full step reduces the residual by the reuse
+   * ratio of the Newton options, otherwise they are rebuilt at the new iterate. Every step is damped by a backtracking line search on
+   * the residual norm, and the inner CG solver only reduces the residual by the linear reduction of the Newton options. The iteration
+   * starts from the current solution with the current boundary values, so a run after another run on the same grid is warm started. 
+   * The multigrid level matrices do not contain the carrier term, so the Jacobian is preconditioned by SSOR if multigrid is selected. 
+   * 
+   * \param newton_options Parameters of the carrier densities and the Newton iteration.
+ 	 * 
+	 */
+template <int dim, class Geometry>
+void PoissonProblem<dim, Geometry>::newton_solve(const NewtonOptions &newton_options)
 {
-  DataOut<dim> data_out;
-  data_out.attach_dof_handler(dof_handler);
-  data_out.add_data_vector(solution, "solution");
-  data_out.build_patches();
-  std::ofstream output(dim == 2 ? "solution-2d.vtk" : "solution-3d.vtk");
-  data_out.write_vtk(output);
+  TimerOutput::Scope timer_section(computing_timer, Sections::solve);
+  std::map<types::global_dof_index, double> boundary_values;
+  interpolate_boundary_values(boundary_values);
+  std::map<types::global_dof_index, double> zero_boundary_values;
+  for (const auto &boundary_value : boundary_values)
+    {
+      solution(boundary_value.first) = boundary_value.second;
+      zero_boundary_values[boundary_value.first] = 0.;
+    }
+  constraints.distribute(solution);
+
+  const unsigned int max_iterations = options.max_iterations > 0 ? options.max_iterations 
+                                                                 : std::max<unsigned int>(1000, dof_handler.n_dofs());
+  SparseMatrix<double> jacobian(sparsity_pattern);
+  SparseMatrix<double> carrier_matrix(sparsity_pattern);
+  PoissonPreconditioner<dim> jacobian_preconditioner(options.preconditioner == PreconditionerType::multigrid 
+                                                       ? PreconditionerType::ssor : options.preconditioner);
+  Vector<double> residual(dof_handler.n_dofs());
+  Vector<double> update(dof_handler.n_dofs());
+  Vector<double> trial(dof_handler.n_dofs());
+
+  double residual_norm = nonlinear_residual(solution, newton_options, boundary_values, residual, nullptr);
+  bool rebuild_jacobian = true;
+  statistics.newton_steps = 0;
+  statistics.jacobian_updates = 0;
+  statistics.cg_iterations = 0;
+  while (residual_norm > newton_options.newton_tolerance && statistics.newton_steps < newton_options.max_newton_steps)
+    {
+      if (rebuild_jacobian)
+        {
+          nonlinear_residual(solution, newton_options, boundary_values, residual, &carrier_matrix);
+          jacobian.copy_from(assembled_matrix);
+          jacobian.add(1., carrier_matrix);
+          MatrixTools::apply_boundary_values(zero_boundary_values, jacobian, update, residual);
+          jacobian_preconditioner.initialize(jacobian, dof_handler);
+          ++statistics.jacobian_updates;
+        }
+
+      update = 0;
+      residual *= -1.;
+      ProgressSolverControl    solver_control(max_iterations, newton_options.linear_reduction * residual_norm, options.progress);
+      SolverCG<Vector<double>> solver(solver_control);
+      solver.solve(jacobian, update, residual, jacobian_preconditioner);
+      constraints.distribute(update);
+      statistics.cg_iterations += solver_control.last_step();
+
+      /* Backtracking line search, the last step length is taken if none reduces the residual sufficiently */
+      double step_length = 1.;
+      double trial_norm = 0.;
+      for (unsigned int i = 1;; ++i)
+        {
+          trial = solution;
+          trial.add(step_length, update);
+          trial_norm = nonlinear_residual(trial, newton_options, boundary_values, residual, nullptr);
+          if (trial_norm <= (1. - 1e-4 * step_length) * residual_norm || i >= newton_options.max_line_search_steps)
+            break;
+          step_length *= 0.5;
+        }
+      solution = trial;
+      rebuild_jacobian = step_length < 1. || trial_norm > newton_options.jacobian_reuse_ratio * residual_norm;
+      residual_norm = trial_norm;
+      ++statistics.newton_steps;
+      std::cout << "   Newton step " << statistics.newton_steps << ": residual " << residual_norm
+                << ", step length " << step_length << ", " << solver_control.last_step() << " CG iterations." << std::endl;
+    }
+  statistics.residual = residual_norm;
+  std::cout << "   " << statistics.newton_steps << " Newton steps with " << statistics.jacobian_updates
+            << " Jacobian assemblies and " << statistics.cg_iterations << " CG iterations in total." << std::endl;
+  AssertThrow(residual_norm <= newton_options.newton_tolerance,
+              ExcMessage("The Newton iteration did not converge, residual " + std::to_string(residual_norm) + "."));
+}
+
+/**
+	 * Estimate the error of the solution and refine the grid where it is largest, if adaptive refinement is selected in the solver options,
+   * see refine_grid_adaptively(). The refined grid needs a new system, so the assembled state and the stored function values are reset. 
+   * 
+   * \param cycle Number of refinement cycles done so far.
+   * \return True if the grid has been refined and the problem has to be solved again
+ 	 * 
+	 */
+template <int dim, class Geometry>
+bool PoissonProblem<dim, Geometry>::refine_grid(const unsigned int cycle)
+{
+  TimerOutput::Scope timer_section(computing_timer, Sections::grid);
+  if (!refine_grid_adaptively(triangulation, dof_handler, solution, options, cycle))
+    return false;
+  assembled = false;
+  source.clear();
+  coefficient.clear();
+  return true;
+}
+
+/**
+	 * Finally, the results are written to a file. Format, directory and name are selected by the solver options, see write_solution(). Writing 
+   * the file can be switched off in the solver options, if the solution is passed to the visualization with solution_mesh() instead. 
+ 	 * 
+	 */
+template <int dim, class Geometry>
+void PoissonProblem<dim, Geometry>::output_results()
+{
+  report_progress(options.progress, SolvePhase::output);
+  TimerOutput::Scope timer_section(computing_timer, Sections::output);
+  if (!options.write_output)
+    return;
+
+  output_file = write_solution(dof_handler, solution, options, geometry.output_name(), n_runs);
 }
 
 /**
 	 * The run function is the main function of the class, that will trigger all other functions. Since there is only one API-like access point to the class,
    * the system is ot error prone. 
    * 
-   * \param _bc Boundary condition for changed parameters, the grid can be reused. 
+   * \param _bc Boundary condition for changed parameters, the grid and the assembled system can be reused. Only the boundary values are
+   * applied again before solving. 
+   * \return Statistics of the run, see SolveStatistics
  	 * 
 	 */
-template <int dim>
-void Poisson<dim>::run(int _bc)
+template <int dim, class Geometry>
+SolveStatistics PoissonProblem<dim, Geometry>::run(int _bc)
 {
   bc = _bc;
-  std::cout << "Solving problem in " << dim << " space dimensions."
+  std::cout << "Solving " << geometry.description() << " in " << dim << " space dimensions."
             << std::endl;
-  setup_system();
-  assemble_system();
+  if (assembled)
+    apply_boundary_values();
+  else
+    {
+      setup_system();
+      assemble_system();
+    }
   solve();
   output_results();
+  return finish_run();
 }
 
 /**
 	 * The run function is the main function of the class, that will trigger all other functions. Since there is only one API-like access point to the class,
-   * the system is ot error prone. 
+   * the system is ot error prone. With adaptive refinement in the solver options, the problem is solved on successively refined grids
+   * until the estimated error or the DoF budget is reached, only the solution on the final grid is written. 
+   * 
+   * \return Statistics of the run, see SolveStatistics
  	 * 
 	 */
-template <int dim>
-void Poisson<dim>::run()
+template <int dim, class Geometry>
+SolveStatistics PoissonProblem<dim, Geometry>::run()
 {
-  std::cout << "Solving problem in " << dim << " space dimensions."
+  std::cout << "Solving " << geometry.description() << " in " << dim << " space dimensions."
             << std::endl;
-  setup_system();
-  assemble_system();
+  for (unsigned int cycle = 0;; ++cycle)
+    {
+      setup_system();
+      assemble_system();
+      solve();
+      if (!refine_grid(cycle))
+        break;
+    }
+  output_results();
+  return finish_run();
+}
+
+/**
+	 * Solve the nonlinear Poisson-Boltzmann equation -div(a grad u) + n_i (exp(u / V_T) - exp(-u / V_T)) = f with the source, the coefficient
+   * and the boundary values of the linear problem, see newton_solve(). The grid, the sparsity pattern and the stiffness matrix are set up
+   * and assembled only if the grid has no assembled system yet, so a sweep over boundary values or carrier parameters on the same grid
+   * reuses them and starts every Newton iteration from the previous solution. Only available with an assembled system matrix. 
+   * 
+   * \param newton_options Parameters of the carrier densities and the Newton iteration.
+   * \return Statistics of the run, including the number of Newton steps and Jacobian assemblies
+ 	 * 
+	 */
+template <int dim, class Geometry>
+SolveStatistics PoissonProblem<dim, Geometry>::run_nonlinear(const NewtonOptions &newton_options)
+{
+  AssertThrow(!options.matrix_free, ExcMessage("The Newton solver needs the assembled system matrix."));
+  std::cout << "Solving nonlinear " << geometry.description() << " in " << dim << " space dimensions."
+            << std::endl;
+  if (!assembled)
+    {
+      setup_system();
+      assemble_system();
+    }
+  newton_solve(newton_options);
+  output_results();
+  return finish_run();
+}
+
+/**
+	 * Solve the problem for a whole list of constant boundary values at the cost of two solves. The solution depends linearly on the
+   * boundary value c, u_c = u_0 + c w, where u_0 is the solution with zero boundary values and w = u_1 - u_0 solves the Laplace equation
+   * without source and with unit boundary values. Both are computed with the assembled system, every boundary value is then a single
+   * vector update. Since u_0 and w are only accurate to the solver tolerance, the error of u_c grows with |c|. Only available for the constant boundary values. 
+   * The solution of the last boundary value is kept for solution_mesh() and the output. 
+   * 
+   * \param boundary_values Constant Dirichlet boundary values of the sweep
+   * \return Solutions in the order of the boundary values
+ 	 * 
+	 */
+template <int dim, class Geometry>
+std::vector<Vector<double>> PoissonProblem<dim, Geometry>::run_sweep(const std::vector<double> &boundary_values)
+{
+  AssertThrow(homogeneous, ExcMessage("A boundary value sweep needs constant boundary values."));
+  std::cout << "Solving " << geometry.description() << " in " << dim << " space dimensions for " << boundary_values.size()
+            << " boundary values." << std::endl;
+  const int sweep_bc = bc;
+
+  /* Source part with zero boundary values */
+  bc = 0;
+  if (assembled)
+    apply_boundary_values();
+  else
+    {
+      setup_system();
+      assemble_system();
+    }
+  solve();
+  const Vector<double> source_solution = solution;
+
+  /* Unit boundary values, the difference to the source part is the boundary part w */
+  bc = 1;
+  apply_boundary_values();
   solve();
+  Vector<double> boundary_solution = solution;
+  boundary_solution -= source_solution;
+  bc = sweep_bc;
+
+  std::vector<Vector<double>> solutions(boundary_values.size(), source_solution);
+  for (unsigned int i = 0; i < boundary_values.size(); ++i)
+    solutions[i].add(boundary_values[i], boundary_solution);
+
+  if (!solutions.empty())
+    solution = solutions.back();
   output_results();
+  finish_run();
+  return solutions;
+}
+
+/**
+	 * Complete the statistics of the run with the size of the system and the wall times of the TimerOutput sections. The table of the
+   * sections is printed if selected in the solver options, then the timer is reset, so every run reports only its own phases. 
+   * 
+   * \return Statistics of the finished run
+ 	 * 
+	 */
+template <int dim, class Geometry>
+SolveStatistics PoissonProblem<dim, Geometry>::finish_run()
+{
+  statistics.n_dofs = dof_handler.n_dofs();
+  statistics.n_active_cells = triangulation.n_active_cells();
+  statistics.n_nonzero_elements = options.matrix_free ? 0 : system_matrix.n_nonzero_elements();
+  collect_statistics(computing_timer, statistics);
+  if (options.print_timings)
+    computing_timer.print_summary();
+  computing_timer.reset();
+  ++n_runs;
+  return statistics;
+}
+
+/**
+	 * Provide the solution as vertices, cells and vertex values that can be handed to VTK without writing and reading a file.
+ 	 * 
+	 */
+template <int dim, class Geometry>
+std::shared_ptr<SolutionMesh> PoissonProblem<dim, Geometry>::solution_mesh() const
+{
+  return build_solution_mesh(dof_handler, solution);
+}
+
+
+/**
+	 * Name of the last written output file, empty if no file was written yet.
+ 	 * 
+	 */
+template <int dim, class Geometry>
+const std::string &PoissonProblem<dim, Geometry>::last_output_file() const
+{
+  return output_file;
+}
+
+
+/**
+	 * Number of degrees of freedom of the current grid.
+ 	 * 
+	 */
+template <int dim, class Geometry>
+types::global_dof_index PoissonProblem<dim, Geometry>::n_dofs() const
+{
+  return dof_handler.n_dofs();
+}
+
+/**
+	 * Select the boundary values for the next run(int). The assembled system does not depend on the boundary values, so switching between
+   * the constant value and the ones given by BoundaryValues does not need a new grid or assembly. 
+   * 
+   * \param _homogeneous If true, the constant boundary values are applied, otherwise the ones given by BoundaryValues
+ 	 * 
+	 */
+template <int dim, class Geometry>
+void PoissonProblem<dim, Geometry>::set_homogeneous(bool _homogeneous)
+{
+  if (_homogeneous != homogeneous)
+    solution_history.clear();
+  homogeneous = _homogeneous;
+}
+
+/**
+	 * Memory used by the grid, the degrees of freedom, the system, the preconditioner and the stored function values in bytes. The LU
+   * factorization of the direct solver is not counted, SparseDirectUMFPACK does not report the size of its factors.
+ 	 * 
+	 */
+template <int dim, class Geometry>
+std::size_t PoissonProblem<dim, Geometry>::memory_consumption() const
+{
+  return triangulation.memory_consumption() + dof_handler.memory_consumption() + constraints.memory_consumption() +
+         sparsity_pattern.memory_consumption() + system_matrix.memory_consumption() + assembled_matrix.memory_consumption() +
+         solution.memory_consumption() + system_rhs.memory_consumption() + assembled_rhs.memory_consumption() +
+         preconditioner.memory_consumption() + mixed_precision_solver.memory_consumption() +
+         (matrix_free_problem ? matrix_free_problem->memory_consumption() : 0) + source.memory_consumption() + coefficient.memory_consumption() + solution_history.memory_consumption();
+}
+
+/**
+	 * Set the source term f of the equation -div(a grad u) = f, nullptr restores f = 1. The grid is kept, the system is assembled
+   * again in the next run, the values of the coefficient at the quadrature points are reused. 
+   * 
+   * \param _source Source term, e.g. a charge density
+ 	 * 
+	 */
+template <int dim, class Geometry>
+void PoissonProblem<dim, Geometry>::set_source(const std::shared_ptr<const Function<dim>> &_source)
+{
+  source.set_function(_source);
+  assembled = false;
+}
+
+/**
+	 * Set the coefficient a of the equation -div(a grad u) = f, nullptr restores a = 1. The grid is kept, the system and the
+   * preconditioner are assembled again in the next run, the values of the source at the quadrature points are reused. 
+   * 
+   * \param _coefficient Coefficient, e.g. a spatially varying permittivity
+ 	 * 
+	 */
+template <int dim, class Geometry>
+void PoissonProblem<dim, Geometry>::set_coefficient(const std::shared_ptr<const Function<dim>> &_coefficient)
+{
+  coefficient.set_function(_coefficient);
+  assembled = false;
+}
+
+/**
+	 * Set the Dirichlet values that are applied if the boundary values are not homogeneous, nullptr restores BoundaryValues. Like
+   * set_homogeneous(), this does not need a new grid or assembly. 
+   * 
+   * \param _boundary_function Dirichlet values on boundary 0
+ 	 * 
+	 */
+template <int dim, class Geometry>
+void PoissonProblem<dim, Geometry>::set_boundary_function(const std::shared_ptr<const Function<dim>> &_boundary_function)
+{
+  boundary_function = _boundary_function ? _boundary_function : std::make_shared<BoundaryValues<dim>>();
+  solution_history.clear();
 }
+
+/**
+ *  Class for calculating the poisson problem on a hyper rectangular domain in 2D and 3D.
+ */
+template <int dim>
+class Poisson : public PoissonProblem<dim, HyperRectangle<dim>>
+{
+public:
+  /**
+   *  \param _dimensions Dimensions of hyper rectangle defined by two points: origin and point with dimensions coordinates.
+   *  For the other parameters see PoissonProblem.
+   */
+  Poisson(std::vector<int> _dimensions, int _refinement, int _shape_function, int _bc, bool _homogeneous, SolverOptions _options = SolverOptions())
+    : PoissonProblem<dim, HyperRectangle<dim>>(HyperRectangle<dim>(_dimensions), _refinement, _shape_function, _bc, _homogeneous, _options)
+  {}
+};
+
+/**
+ *  Class for calculating the poisson problem on a 2D ring with constant boundary values. 3D shells are solved by
+ *  PoissonProblem<3, HyperShell<3>>.
+ */
+class Radial_Poisson : public PoissonProblem<2, HyperShell<2>>
+{
+public:
+  /**
+   *  \param _dimensions Dimensions of 2D donut defined by two values, inner and outer radius.
+   *  For the other parameters see PoissonProblem.
+   */
+  Radial_Poisson(std::vector<double> _dimensions, int _refinement, int _shape_function, int _bc, SolverOptions _options = SolverOptions())
+    : PoissonProblem<2, HyperShell<2>>(HyperShell<2>(_dimensions), _refinement, _shape_function, _bc, true, _options)
+  {}
+};
+
+/* The problems used by the executables are instantiated once in poisson.cpp */
+extern template class PoissonProblem<2, HyperRectangle<2>>;
+extern template class PoissonProblem<3, HyperRectangle<3>>;
+extern template class PoissonProblem<2, HyperShell<2>>;
+extern template class PoissonProblem<3, HyperShell<3>>;
+extern template class PoissonProblem<2, ImportedMesh<2>>;
+extern template class PoissonProblem<3, ImportedMesh<3>>;
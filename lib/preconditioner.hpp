@@ -0,0 +1,368 @@
+/**
+ * \file preconditioner.hpp
+ *
+ * Preconditioners for the Conjugate Gradients solver of the Poisson problems
+ */
+
+#pragma once
+
+#include "solver_options.hpp"
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/function.h>
+
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/precondition.h>
+
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+#include <deal.II/multigrid/multigrid.h>
+#include <deal.II/multigrid/mg_transfer.h>
+#include <deal.II/multigrid/mg_tools.h>
+#include <deal.II/multigrid/mg_coarse.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_matrix.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace dealii;
+
+/**
+ *  Class for the geometric multigrid preconditioner. The level matrices of the Laplace operator are assembled on every
+ *  level of the refinement hierarchy of the triangulation and one V-cycle with symmetric SOR smoothing is applied per
+ *  preconditioner application. Boundary (id 0) and refinement edge degrees of freedom are treated as in step-16 of the
+ *  deal.II tutorial, which makes the number of CG iterations independent of the refinement level. The level matrices and
+ *  vectors are stored with the given number type, float halves the memory traffic of the V-cycle.
+ */
+template <int dim, typename number = double>
+class MultigridPreconditioner
+{
+public:
+  void initialize(const DoFHandler<dim> &dof_handler, const Function<dim> *coefficient = nullptr);
+  void vmult(Vector<number> &dst, const Vector<number> &src) const;
+  std::size_t memory_consumption() const;
+
+private:
+  void setup_level_matrices(const DoFHandler<dim> &dof_handler);
+  void assemble_level_matrices(const DoFHandler<dim> &dof_handler, const Function<dim> *coefficient);
+
+  using Smoother = PreconditionSOR<SparseMatrix<number>>;
+
+  MGConstrainedDoFs mg_constrained_dofs;                      //!< Boundary and refinement edge indices on each level
+  MGLevelObject<SparsityPattern> mg_sparsity_patterns;        //!< Sparsity patterns of the level matrices
+  MGLevelObject<SparsityPattern> mg_interface_sparsity_patterns; //!< Sparsity patterns of the refinement edge matrices
+  MGLevelObject<SparseMatrix<number>> mg_matrices;            //!< Laplace matrix on each level
+  MGLevelObject<SparseMatrix<number>> mg_interface_matrices;  //!< Coupling across refinement edges on each level
+
+  MGTransferPrebuilt<Vector<number>> mg_transfer;             //!< Prolongation and restriction between the levels
+  FullMatrix<number> coarse_matrix;                           //!< Level matrix of the coarsest level
+  MGCoarseGridHouseholder<number, Vector<number>> coarse_grid_solver; //!< Direct solver on the coarsest level
+  mg::SmootherRelaxation<Smoother, Vector<number>> mg_smoother; //!< Symmetric SOR smoother on each level
+  mg::Matrix<Vector<number>> mg_matrix;                       //!< Wrapper of the level matrices
+  mg::Matrix<Vector<number>> mg_interface_up;                 //!< Wrapper of the refinement edge matrices
+  mg::Matrix<Vector<number>> mg_interface_down;               //!< Wrapper of the transposed refinement edge matrices
+
+  std::unique_ptr<Multigrid<Vector<number>>> mg;              //!< Multigrid V-cycle
+  std::unique_ptr<PreconditionMG<dim, Vector<number>, MGTransferPrebuilt<Vector<number>>>> preconditioner; //!< Multigrid as preconditioner on the active level
+};
+
+/**
+ *  Class that wraps the preconditioner selected in the SolverOptions behind a single vmult() function, so the CG solver
+ *  of the Poisson problems does not have to know which one is used. With number = float the preconditioner is built from
+ *  and applied to single precision matrices and vectors, see MixedPrecisionSolver.
+ */
+template <int dim, typename number = double>
+class PoissonPreconditioner
+{
+public:
+  PoissonPreconditioner(PreconditionerType _type);
+  void initialize(const SparseMatrix<number> &system_matrix, const DoFHandler<dim> &dof_handler,
+                  const Function<dim> *coefficient = nullptr);
+  void vmult(Vector<number> &dst, const Vector<number> &src) const;
+  std::string name() const;
+  std::size_t memory_consumption() const;
+
+private:
+  PreconditionerType type;              //!< Selected preconditioner
+
+  PreconditionSSOR<SparseMatrix<number>> ssor;                             //!< SSOR preconditioner
+  PreconditionChebyshev<SparseMatrix<number>, Vector<number>> chebyshev;   //!< Chebyshev preconditioner
+  std::shared_ptr<DiagonalMatrix<Vector<number>>> chebyshev_diagonal;     //!< Inverse diagonal of the system matrix for the Chebyshev preconditioner
+  std::unique_ptr<MultigridPreconditioner<dim, number>> multigrid;         //!< Geometric multigrid preconditioner
+};
+
+/**
+	 * Create all multigrid objects for the level hierarchy of the given DoFHandler. The multilevel degrees of freedom have to be
+   * distributed before, see DoFHandler::distribute_mg_dofs().
+   *
+   * \param dof_handler DoFHandler with distributed active and multilevel degrees of freedom.
+   * \param coefficient Coefficient of the Laplace operator, nullptr for the constant 1.
+ 	 *
+	 */
+template <int dim, typename number>
+void MultigridPreconditioner<dim, number>::initialize(const DoFHandler<dim> &dof_handler, const Function<dim> *coefficient)
+{
+  mg_constrained_dofs.clear();
+  mg_constrained_dofs.initialize(dof_handler);
+  const std::set<types::boundary_id> dirichlet_boundary_ids = {0};
+  mg_constrained_dofs.make_zero_boundary_constraints(dof_handler, dirichlet_boundary_ids);
+
+  setup_level_matrices(dof_handler);
+  assemble_level_matrices(dof_handler, coefficient);
+
+  mg_transfer.initialize_constraints(mg_constrained_dofs);
+  mg_transfer.build(dof_handler);
+
+  coarse_matrix.copy_from(mg_matrices[0]);
+  coarse_grid_solver.initialize(coarse_matrix);
+
+  mg_smoother.initialize(mg_matrices);
+  mg_smoother.set_steps(2);
+  mg_smoother.set_symmetric(true);
+
+  mg_matrix.initialize(mg_matrices);
+  mg_interface_up.initialize(mg_interface_matrices);
+  mg_interface_down.initialize(mg_interface_matrices);
+
+  mg = std::make_unique<Multigrid<Vector<number>>>(mg_matrix, coarse_grid_solver, mg_transfer, mg_smoother, mg_smoother);
+  mg->set_edge_matrices(mg_interface_down, mg_interface_up);
+
+  preconditioner = std::make_unique<PreconditionMG<dim, Vector<number>, MGTransferPrebuilt<Vector<number>>>>(dof_handler, *mg, mg_transfer);
+}
+
+/**
+	 * Set up the sparsity patterns and matrices on all levels of the triangulation.
+ 	 *
+	 */
+template <int dim, typename number>
+void MultigridPreconditioner<dim, number>::setup_level_matrices(const DoFHandler<dim> &dof_handler)
+{
+  const unsigned int n_levels = dof_handler.get_triangulation().n_levels();
+
+  mg_interface_matrices.resize(0, n_levels - 1);
+  mg_matrices.resize(0, n_levels - 1);
+  mg_sparsity_patterns.resize(0, n_levels - 1);
+  mg_interface_sparsity_patterns.resize(0, n_levels - 1);
+
+  for (unsigned int level = 0; level < n_levels; ++level)
+    {
+      {
+        DynamicSparsityPattern dsp(dof_handler.n_dofs(level), dof_handler.n_dofs(level));
+        MGTools::make_sparsity_pattern(dof_handler, dsp, level);
+        mg_sparsity_patterns[level].copy_from(dsp);
+        mg_matrices[level].reinit(mg_sparsity_patterns[level]);
+      }
+      {
+        DynamicSparsityPattern dsp(dof_handler.n_dofs(level), dof_handler.n_dofs(level));
+        MGTools::make_interface_sparsity_pattern(dof_handler, mg_constrained_dofs, dsp, level);
+        mg_interface_sparsity_patterns[level].copy_from(dsp);
+        mg_interface_matrices[level].reinit(mg_interface_sparsity_patterns[level]);
+      }
+    }
+}
+
+/**
+	 * Assemble the Laplace matrix on every level. Boundary and refinement edge degrees of freedom are eliminated from the level
+   * matrices, the couplings across refinement edges are collected in the interface matrices. The level matrices use the same
+   * coefficient as the system matrix, otherwise the coarse grid corrections would not fit a strongly varying coefficient.
+   *
+   * \param dof_handler DoFHandler with distributed active and multilevel degrees of freedom.
+   * \param coefficient Coefficient of the Laplace operator, nullptr for the constant 1.
+ 	 *
+	 */
+template <int dim, typename number>
+void MultigridPreconditioner<dim, number>::assemble_level_matrices(const DoFHandler<dim> &dof_handler, const Function<dim> *coefficient)
+{
+  const FiniteElement<dim> &fe = dof_handler.get_fe();
+  QGauss<dim> quadrature_formula(fe.degree + 1);
+  FEValues<dim> fe_values(fe, quadrature_formula, update_gradients | update_quadrature_points | update_JxW_values);
+  const unsigned int dofs_per_cell = fe.n_dofs_per_cell();
+  std::vector<double> coefficient_values(quadrature_formula.size(), 1.);
+
+  FullMatrix<number> cell_matrix(dofs_per_cell, dofs_per_cell);
+  std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
+
+  const unsigned int n_levels = dof_handler.get_triangulation().n_levels();
+  std::vector<AffineConstraints<number>> boundary_constraints(n_levels);
+  for (unsigned int level = 0; level < n_levels; ++level)
+    {
+      boundary_constraints[level].add_lines(mg_constrained_dofs.get_refinement_edge_indices(level));
+      boundary_constraints[level].add_lines(mg_constrained_dofs.get_boundary_indices(level));
+      boundary_constraints[level].close();
+    }
+
+  for (const auto &cell : dof_handler.cell_iterators())
+    {
+      fe_values.reinit(cell);
+      if (coefficient)
+        coefficient->value_list(fe_values.get_quadrature_points(), coefficient_values);
+      cell_matrix = 0;
+      for (const unsigned int q_index : fe_values.quadrature_point_indices())
+        for (const unsigned int i : fe_values.dof_indices())
+          for (const unsigned int j : fe_values.dof_indices())
+            cell_matrix(i, j) += (coefficient_values[q_index] *
+                                  fe_values.shape_grad(i, q_index) *
+                                  fe_values.shape_grad(j, q_index) *
+                                  fe_values.JxW(q_index));
+
+      cell->get_mg_dof_indices(local_dof_indices);
+      const unsigned int level = cell->level();
+      boundary_constraints[level].distribute_local_to_global(cell_matrix, local_dof_indices, mg_matrices[level]);
+
+      for (const unsigned int i : fe_values.dof_indices())
+        for (const unsigned int j : fe_values.dof_indices())
+          if (mg_constrained_dofs.is_interface_matrix_entry(level, local_dof_indices[i], local_dof_indices[j]))
+            mg_interface_matrices[level].add(local_dof_indices[i], local_dof_indices[j], cell_matrix(i, j));
+    }
+}
+
+/**
+	 * Apply one multigrid V-cycle.
+ 	 *
+	 */
+template <int dim, typename number>
+void MultigridPreconditioner<dim, number>::vmult(Vector<number> &dst, const Vector<number> &src) const
+{
+  preconditioner->vmult(dst, src);
+}
+
+/**
+	 * Memory used by the level matrices, their sparsity patterns and the transfer matrices in bytes.
+ 	 *
+	 */
+template <int dim, typename number>
+std::size_t MultigridPreconditioner<dim, number>::memory_consumption() const
+{
+  return mg_sparsity_patterns.memory_consumption() + mg_interface_sparsity_patterns.memory_consumption() +
+         mg_matrices.memory_consumption() + mg_interface_matrices.memory_consumption() +
+         mg_transfer.memory_consumption() + coarse_matrix.memory_consumption();
+}
+
+/**
+	 * Constructor for the PoissonPreconditioner class
+	 *
+	 * \param _type Preconditioner that is built by initialize() and applied by vmult().
+	 * \return Constructed preconditioner class object
+	 */
+template <int dim, typename number>
+PoissonPreconditioner<dim, number>::PoissonPreconditioner(PreconditionerType _type)
+  : type(_type)
+{}
+
+/**
+	 * Build the selected preconditioner for the system matrix with applied boundary values. Since eliminating the boundary values
+   * does not depend on the values themselves, the preconditioner stays valid for re-solves with changed boundary values.
+   *
+   * \param system_matrix System matrix with applied boundary values.
+   * \param dof_handler DoFHandler of the problem, the multigrid preconditioner needs distributed multilevel degrees of freedom.
+   * \param coefficient Coefficient of the Laplace operator for the multigrid level matrices, nullptr for the constant 1.
+ 	 *
+	 */
+template <int dim, typename number>
+void PoissonPreconditioner<dim, number>::initialize(const SparseMatrix<number> &system_matrix, const DoFHandler<dim> &dof_handler,
+                                            const Function<dim> *coefficient)
+{
+  switch (type)
+    {
+      case PreconditionerType::identity:
+        break;
+
+      case PreconditionerType::ssor:
+        ssor.initialize(system_matrix, 1.2);
+        break;
+
+      case PreconditionerType::chebyshev:
+        {
+          using Chebyshev = PreconditionChebyshev<SparseMatrix<number>, Vector<number>>;
+          typename Chebyshev::AdditionalData data;
+          data.degree = 5;
+          data.smoothing_range = 100.;
+          chebyshev_diagonal = std::make_shared<DiagonalMatrix<Vector<number>>>();
+          data.preconditioner = chebyshev_diagonal;
+          Vector<number> &inverse_diagonal = chebyshev_diagonal->get_vector();
+          inverse_diagonal.reinit(system_matrix.m());
+          for (unsigned int i = 0; i < system_matrix.m(); ++i)
+            inverse_diagonal(i) = 1. / system_matrix.diag_element(i);
+          chebyshev.initialize(system_matrix, data);
+          break;
+        }
+
+      case PreconditionerType::multigrid:
+        multigrid = std::make_unique<MultigridPreconditioner<dim, number>>();
+        multigrid->initialize(dof_handler, coefficient);
+        break;
+    }
+}
+
+/**
+	 * Apply the selected preconditioner.
+ 	 *
+	 */
+template <int dim, typename number>
+void PoissonPreconditioner<dim, number>::vmult(Vector<number> &dst, const Vector<number> &src) const
+{
+  switch (type)
+    {
+      case PreconditionerType::identity:
+        dst = src;
+        break;
+      case PreconditionerType::ssor:
+        ssor.vmult(dst, src);
+        break;
+      case PreconditionerType::chebyshev:
+        chebyshev.vmult(dst, src);
+        break;
+      case PreconditionerType::multigrid:
+        multigrid->vmult(dst, src);
+        break;
+    }
+}
+
+/**
+	 * Name of the selected preconditioner for the solver output.
+ 	 *
+	 */
+template <int dim, typename number>
+std::string PoissonPreconditioner<dim, number>::name() const
+{
+  switch (type)
+    {
+      case PreconditionerType::ssor:
+        return "SSOR";
+      case PreconditionerType::chebyshev:
+        return "Chebyshev";
+      case PreconditionerType::multigrid:
+        return "geometric multigrid";
+      default:
+        return "identity";
+    }
+}
+
+/**
+	 * Memory used by the selected preconditioner in bytes. SSOR works on the system matrix and stores nothing of its own, Chebyshev
+   * stores the inverse diagonal, its work vectors are not counted.
+ 	 *
+	 */
+template <int dim, typename number>
+std::size_t PoissonPreconditioner<dim, number>::memory_consumption() const
+{
+  switch (type)
+    {
+      case PreconditionerType::chebyshev:
+        return chebyshev_diagonal ? chebyshev_diagonal->memory_consumption() : 0;
+      case PreconditionerType::multigrid:
+        return multigrid ? multigrid->memory_consumption() : 0;
+      default:
+        return 0;
+    }
+}
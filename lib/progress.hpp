@@ -0,0 +1,75 @@
+/**
+ * \file progress.hpp
+ *
+ * Progress reporting and cancellation of the Poisson solvers
+ */
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <functional>
+
+using namespace dealii;
+
+/**
+ *  Phases of a Poisson solve that are reported to the progress callback.
+ */
+enum class SolvePhase
+{
+  grid,                                 //!< Generation and refinement of the triangulation
+  dofs,                                 //!< Distribution of the degrees of freedom and setup of the system
+  assembly,                             //!< Assembly of the system or application of new boundary values
+  solve,                                //!< CG iterations, the step is the current iteration
+  output                                //!< Output of the results
+};
+
+/**
+ *  Function that is called at the beginning of every phase and after every CG iteration. The step is the number of
+ *  the CG iteration in the solve phase and 0 otherwise. Returning false cancels the solve.
+ */
+using ProgressCallback = std::function<bool(SolvePhase phase, unsigned int step)>;
+
+/**
+ *  Exception thrown when the progress callback cancels a solve.
+ */
+DeclExceptionMsg(ExcSolveCancelled, "The solve was cancelled by the progress callback.");
+
+/**
+	 * Report the beginning of a phase to the progress callback, if one is set.
+   *
+   * \param progress Progress callback of the solver options.
+   * \param phase Phase that is reported.
+   * \param step Current CG iteration in the solve phase.
+ 	 *
+	 */
+inline void report_progress(const ProgressCallback &progress, const SolvePhase phase, const unsigned int step = 0)
+{
+  if (progress)
+    AssertThrow(progress(phase, step), ExcSolveCancelled());
+}
+
+/**
+ *  Class for the stopping criteria of the CG solver that additionally reports every iteration to the progress callback,
+ *  so long solves can be observed and cancelled.
+ */
+class ProgressSolverControl : public SolverControl
+{
+public:
+  ProgressSolverControl(const unsigned int max_iterations, const double tolerance, const ProgressCallback &_progress)
+    : SolverControl(max_iterations, tolerance), progress(_progress)
+  {}
+
+  /**
+   *  Report the iteration and check the residual like SolverControl.
+   */
+  State check(const unsigned int step, const double check_value) override
+  {
+    report_progress(progress, SolvePhase::solve, step);
+    return SolverControl::check(step, check_value);
+  }
+
+private:
+  ProgressCallback progress;            //!< Progress callback of the solver options
+};
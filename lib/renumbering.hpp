@@ -0,0 +1,44 @@
+/**
+ * \file renumbering.hpp
+ *
+ * Renumbering of the degrees of freedom for a better memory locality of the system matrix
+ */
+
+#pragma once
+
+#include "solver_options.hpp"
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_renumbering.h>
+
+using namespace dealii;
+
+/**
+	 * Renumber the degrees of freedom in the order selected by the solver options. distribute_dofs() numbers the degrees of freedom
+   * cell by cell in the order of the cells, so neighbouring degrees of freedom can end up far apart. Cuthill-McKee reduces the bandwidth of
+   * the matrix, so the entries of the solution vector read by one matrix row are close to each other in memory. The hierarchical order
+   * follows a Z-shaped space filling curve through the refinement tree, which keeps the degrees of freedom of neighbouring cells together
+   * on locally refined grids as well.
+   *
+   * \param dof_handler DoFHandler with distributed degrees of freedom.
+   * \param renumbering Order of the degrees of freedom.
+ 	 *
+	 */
+template <int dim>
+void renumber_dofs(DoFHandler<dim> &dof_handler, const RenumberingType renumbering)
+{
+  switch (renumbering)
+    {
+      case RenumberingType::none:
+        break;
+      case RenumberingType::cuthill_mckee:
+        DoFRenumbering::Cuthill_McKee(dof_handler);
+        break;
+      case RenumberingType::reverse_cuthill_mckee:
+        DoFRenumbering::Cuthill_McKee(dof_handler, true);
+        break;
+      case RenumberingType::hierarchical:
+        DoFRenumbering::hierarchical(dof_handler);
+        break;
+    }
+}
@@ -0,0 +1,76 @@
+/**
+ * \file solution_mesh.hpp
+ *
+ * In-memory representation of the solution for the visualization
+ */
+
+#pragma once
+
+#include <deal.II/base/geometry_info.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <memory>
+#include <vector>
+
+using namespace dealii;
+
+/**
+ *  Solution on the active cells of the triangulation in the layout of an unstructured VTK grid. The arrays can be wrapped by
+ *  VTK data arrays without copying them, the visualization only has to keep the SolutionMesh alive. Like the VTK output of
+ *  DataOut without subdivisions, every cell is represented by its vertices.
+ */
+struct SolutionMesh
+{
+  unsigned int dim = 2;                 //!< Dimension of the cells, quadrilaterals in 2D and hexahedra in 3D
+  std::vector<double> points;           //!< Coordinates of all vertices of the triangulation, three per vertex
+  std::vector<long long> offsets;       //!< Start of every cell in connectivity, followed by the size of connectivity
+  std::vector<long long> connectivity;  //!< Vertex indices of all cells in VTK ordering
+  std::vector<double> values;           //!< Solution value at every vertex
+};
+
+/**
+	 * Collect the vertices, cells and vertex values of the solution. The vertices are shared between the cells and the values are
+   * read directly from the vertex degrees of freedom of the FE_Q element, so no patches have to be built.
+   *
+   * \param dof_handler DoFHandler of the problem.
+   * \param solution Solution vector.
+   * \return Solution mesh with 64 bit indices as used by vtkCellArray
+ 	 *
+	 */
+template <int dim>
+std::shared_ptr<SolutionMesh> build_solution_mesh(const DoFHandler<dim> &dof_handler, const Vector<double> &solution)
+{
+  /* deal.II numbers the vertices of a cell lexicographically, VTK counterclockwise */
+  const unsigned int vtk_vertex_order[8] = {0, 1, 3, 2, 4, 5, 7, 6};
+
+  auto mesh = std::make_shared<SolutionMesh>();
+  mesh->dim = dim;
+
+  const std::vector<Point<dim>> &vertices = dof_handler.get_triangulation().get_vertices();
+  mesh->points.assign(3 * vertices.size(), 0.);
+  for (unsigned int v = 0; v < vertices.size(); ++v)
+    for (unsigned int d = 0; d < dim; ++d)
+      mesh->points[3 * v + d] = vertices[v][d];
+
+  const unsigned int n_cells = dof_handler.get_triangulation().n_active_cells();
+  mesh->offsets.reserve(n_cells + 1);
+  mesh->connectivity.reserve(n_cells * GeometryInfo<dim>::vertices_per_cell);
+  mesh->values.assign(vertices.size(), 0.);
+
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    {
+      mesh->offsets.push_back(mesh->connectivity.size());
+      for (unsigned int i = 0; i < GeometryInfo<dim>::vertices_per_cell; ++i)
+        {
+          const unsigned int v = vtk_vertex_order[i];
+          mesh->connectivity.push_back(cell->vertex_index(v));
+          mesh->values[cell->vertex_index(v)] = solution(cell->vertex_dof_index(v, 0));
+        }
+    }
+  mesh->offsets.push_back(mesh->connectivity.size());
+
+  return mesh;
+}
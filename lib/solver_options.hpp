@@ -0,0 +1,97 @@
+/**
+ * \file solver_options.hpp
+ *
+ * Options for the linear solver of the Poisson problems
+ */
+
+#pragma once
+
+#include "progress.hpp"
+
+#include <string>
+
+/**
+ *  Preconditioners that can be used by the Conjugate Gradients solver.
+ */
+enum class PreconditionerType
+{
+  identity,                             //!< No preconditioning
+  ssor,                                 //!< Symmetric successive over-relaxation
+  chebyshev,                            //!< Chebyshev polynomial of the diagonally scaled system matrix
+  multigrid                             //!< Geometric multigrid V-cycle on the refinement hierarchy of the triangulation
+};
+
+/**
+ *  Solvers for the linear system of the Poisson problems.
+ */
+enum class LinearSolverType
+{
+  cg,                                   //!< Conjugate Gradients with the selected preconditioner
+  direct,                               //!< LU factorization with UMFPACK, reused for all solves on the same grid, needs deal.II with UMFPACK
+  automatic                             //!< Direct solver for 2D systems up to direct_solver_max_dofs degrees of freedom, CG otherwise
+};
+
+/**
+ *  Orders of the degrees of freedom, applied before the sparsity pattern is built.
+ */
+enum class RenumberingType
+{
+  none,                                 //!< Order of distribute_dofs(), cell by cell
+  cuthill_mckee,                        //!< Cuthill-McKee ordering that reduces the bandwidth of the matrix
+  reverse_cuthill_mckee,                //!< Reversed Cuthill-McKee ordering, usually with less fill-in
+  hierarchical                          //!< Z-order space filling curve through the refinement tree
+};
+
+/**
+ *  Initial guesses of the CG solver for re-solves with new boundary values on the same grid, see SolutionHistory.
+ */
+enum class InitialGuessType
+{
+  zero,                                 //!< Start from zero in the interior
+  previous,                             //!< Start from the last solution
+  extrapolated                          //!< Start from the linear extrapolation of the last two solutions in the boundary value
+};
+
+/**
+ *  File formats for the output of the solution.
+ */
+enum class OutputFormat
+{
+  vtk,                                  //!< Legacy ASCII VTK file
+  vtu,                                  //!< Binary VTU file with zlib compression
+  pvtu,                                 //!< Binary VTU piece together with a parallel PVTU record
+  hdf5                                  //!< HDF5 heavy data with an XDMF description, needs deal.II with HDF5
+};
+
+/**
+ *  Collection of the options that control how a Poisson problem is solved. All options have defaults, so only the
+ *  ones that differ have to be set.
+ */
+struct SolverOptions
+{
+  LinearSolverType linear_solver = LinearSolverType::cg; //!< Solver for the linear system
+  unsigned int direct_solver_max_dofs = 100000; //!< Largest 2D system the automatic selection factorizes
+  PreconditionerType preconditioner = PreconditionerType::identity; //!< Preconditioner for the CG solver
+  unsigned int max_iterations = 0;      //!< Maximum number of CG iterations, 0 uses the number of degrees of freedom, but at least 1000
+  double tolerance = 1e-12;             //!< Residual below which the CG solver has converged
+  RenumberingType renumbering = RenumberingType::none; //!< Order of the degrees of freedom
+  InitialGuessType initial_guess = InitialGuessType::extrapolated; //!< Initial guess of the CG solver for re-solves on the same grid
+  bool matrix_free = false;             //!< Apply the Laplace operator matrix-free instead of assembling the system matrix
+  bool mixed_precision = false;         //!< Run the CG iterations in single precision inside a double precision iterative refinement, ignored by the matrix-free solver
+  unsigned int assembly_threads = 0;    //!< Maximum number of threads for the assembly, 0 uses one thread per core
+  bool specialized_assembly = true;     //!< Assemble FE_Q elements of degree 1 to 3 with kernels whose loop bounds are known at compile time
+  bool reuse_congruent_cells = true;    //!< Compute the local system once for cells that are translations of each other, needs a constant source and coefficient
+  bool write_output = true;             //!< Write the solution to a file after solving
+  OutputFormat output_format = OutputFormat::vtk; //!< File format of the output
+  std::string output_directory = "./";  //!< Directory the output is written to, has to end with a slash
+  std::string output_name;              //!< File name without extension, empty uses solution-2d or solution-3d
+  bool numbered_output = false;         //!< Append the number of the run to the file name, so re-solves do not overwrite each other
+  bool adaptive_refinement = false;     //!< Refine the grid where the Kelly estimator finds the largest error and solve again
+  unsigned int max_adaptive_cycles = 8; //!< Maximum number of adaptive refinement cycles
+  double adaptive_tolerance = 0.;       //!< Estimated error below which the adaptive refinement stops
+  unsigned int max_dofs = 0;            //!< Number of degrees of freedom the adaptive refinement must not exceed, 0 for no limit
+  double refine_fraction = 0.6;         //!< Fraction of the estimated error carried by the cells that are refined
+  double coarsen_fraction = 0.02;       //!< Fraction of the estimated error carried by the cells that are coarsened
+  bool print_timings = false;           //!< Print the wall time of every phase as a TimerOutput table after every run
+  ProgressCallback progress;            //!< Called for every phase and CG iteration, returning false cancels the solve
+};
@@ -0,0 +1,85 @@
+/**
+ * \file statistics.hpp
+ *
+ * Timing and size statistics of a Poisson solve
+ */
+
+#pragma once
+
+#include <deal.II/base/timer.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/types.h>
+
+#include <map>
+#include <string>
+
+using namespace dealii;
+
+/**
+ *  Statistics of one run of a Poisson problem. The times are the wall times of the TimerOutput sections of the run in
+ *  seconds, the generation of the grid in the constructor is counted in the first run.
+ */
+struct SolveStatistics
+{
+  double grid_time = 0.;                //!< Generation and adaptive refinement of the grid
+  double setup_time = 0.;               //!< Distribution of the degrees of freedom and setup of the sparsity pattern
+  double assembly_time = 0.;            //!< Assembly of the system and the preconditioner, or application of new boundary values
+  double solve_time = 0.;               //!< CG solve
+  double output_time = 0.;              //!< Output of the solution
+  types::global_dof_index n_dofs = 0;   //!< Number of degrees of freedom of the final grid
+  unsigned int n_active_cells = 0;      //!< Number of active cells of the final grid
+  std::size_t n_nonzero_elements = 0;   //!< Number of stored entries of the system matrix, 0 in matrix-free mode
+  unsigned int cg_iterations = 0;       //!< Number of CG iterations of the last solve, summed over all Newton steps of a nonlinear solve
+  bool warm_start = false;              //!< True if the last solve started from previous solutions, see SolutionHistory
+  int saved_cg_iterations = 0;          //!< CG iterations of the cold solve after the last assembly minus the ones of the warm started solve
+  unsigned int newton_steps = 0;        //!< Number of Newton steps of a nonlinear solve
+  unsigned int jacobian_updates = 0;    //!< Number of Jacobian assemblies of a nonlinear solve
+  double residual = 0.;                 //!< Residual of the last solve, the nonlinear residual of a Newton solve
+  std::size_t peak_memory = 0;          //!< Peak resident memory of the whole process so far in kB, it never decreases between runs
+
+  /**
+   *  Wall time of all sections.
+   */
+  double total_time() const
+  {
+    return grid_time + setup_time + assembly_time + solve_time + output_time;
+  }
+};
+
+/**
+ *  Names of the TimerOutput sections of the Poisson problems.
+ */
+namespace Sections
+{
+  const std::string grid = "Make grid";
+  const std::string setup = "Setup system";
+  const std::string assembly = "Assemble system";
+  const std::string solve = "Solve";
+  const std::string output = "Output results";
+} // namespace Sections
+
+/**
+	 * Copy the wall times of the sections and the peak memory of the process into the statistics. The peak memory is the high-water
+   * mark of the process, it only belongs to this run if the process solves nothing else, see memory_consumption() of the problems.
+   *
+   * \param timer TimerOutput with the sections of the run.
+   * \param statistics Statistics of the run.
+ 	 *
+	 */
+inline void collect_statistics(const TimerOutput &timer, SolveStatistics &statistics)
+{
+  const std::map<std::string, double> times = timer.get_summary_data(TimerOutput::total_wall_time);
+  const auto time = [&times](const std::string &section) {
+    const auto entry = times.find(section);
+    return entry == times.end() ? 0. : entry->second;
+  };
+  statistics.grid_time = time(Sections::grid);
+  statistics.setup_time = time(Sections::setup);
+  statistics.assembly_time = time(Sections::assembly);
+  statistics.solve_time = time(Sections::solve);
+  statistics.output_time = time(Sections::output);
+
+  Utilities::System::MemoryStats memory_stats;
+  Utilities::System::get_memory_stats(memory_stats);
+  statistics.peak_memory = memory_stats.VmHWM;
+}
@@ -0,0 +1,171 @@
+/**
+ *  \file AssemblyCheck.cpp
+ *
+ *  AssemblyCheck Execution File
+ *
+ *  Check of the assembly paths of the Poisson Solver Library. The Laplace system is
+ *  assembled with the generic loop, with the specialized FE_Q kernels and with the reuse
+ *  of congruent cells for the degrees 1 to 3. All variants have to give the same matrix
+ *  and right hand side as the generic loop up to rounding errors. The grids include
+ *  anisotropic, locally refined and curved ones, so the congruence classes of several
+ *  levels, the hanging node constraints and non-affine cells are covered. Grids with a
+ *  source and a coefficient function compare the kernels without the reuse of cells.
+ *
+ *  Usage: AssemblyCheck
+ */
+
+// Includes from the Poisson Solver Library
+#include "../lib/assembly.hpp"
+#include "../lib/geometry.hpp"
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ *  @brief Structure for one assembly path that is compared with the generic loop.
+ */
+struct AssemblyVariant
+{
+    std::string name;                       //!< Name of the variant in the output
+    bool specialized = false;               //!< Use the specialized FE_Q kernels
+    bool reuseCongruentCells = false;       //!< Copy the local systems of congruent cells
+};
+
+/**
+ *  @brief Function that refines the cells near the origin.
+ *
+ *  @param triangulation Triangulation to refine.
+ *  @param steps Number of refinement steps.
+ *
+ *  Every step refines the active cells whose center is closer to the origin than 0.3
+ *  times the diameter of the domain, which leaves hanging nodes and cells of several
+ *  levels in the grid.
+ */
+template <int dim>
+void refineNearOrigin(Triangulation<dim>& triangulation, unsigned int steps)
+{
+    const double radius = 0.3 * GridTools::diameter(triangulation);
+    for (unsigned int step = 0; step < steps; ++step)
+    {
+        for (const auto& cell : triangulation.active_cell_iterators())
+            if (cell->center().norm() < radius)
+                cell->set_refine_flag();
+        triangulation.execute_coarsening_and_refinement();
+    }
+}
+
+/**
+ *  @brief Function that compares all assembly paths on one grid.
+ *
+ *  @param gridName Name of the grid in the output.
+ *  @param triangulation Grid to assemble on.
+ *  @param withFunctions If true, a source and a coefficient function are used.
+ *  @return True if all variants agree with the generic loop for all degrees.
+ */
+template <int dim>
+bool checkGrid(const std::string& gridName, const Triangulation<dim>& triangulation, bool withFunctions)
+{
+    const double tolerance = 1e-12;
+    const std::vector<AssemblyVariant> variants = {{"specialized", true, false},
+                                                   {"generic with reuse", false, true},
+                                                   {"specialized with reuse", true, true}};
+    bool passed = true;
+    for (unsigned int degree = 1; degree <= 3; ++degree)
+    {
+        const FE_Q<dim> fe(degree);
+        DoFHandler<dim> dofHandler(triangulation);
+        dofHandler.distribute_dofs(fe);
+
+        AffineConstraints<double> constraints;
+        DoFTools::make_hanging_node_constraints(dofHandler, constraints);
+        constraints.close();
+        DynamicSparsityPattern dsp(dofHandler.n_dofs());
+        DoFTools::make_sparsity_pattern(dofHandler, dsp, constraints, false);
+        SparsityPattern sparsityPattern;
+        sparsityPattern.copy_from(dsp);
+
+        QuadratureValueCache<dim> source;
+        QuadratureValueCache<dim> coefficient;
+        if (withFunctions)
+        {
+            source.set_function(std::make_shared<ScalarFunctionFromFunctionObject<dim>>(
+                [](const Point<dim>& point) { return 1. + point.square(); }));
+            coefficient.set_function(std::make_shared<ScalarFunctionFromFunctionObject<dim>>(
+                [](const Point<dim>& point) { return 2. + point[0]; }));
+        }
+
+        SparseMatrix<double> referenceMatrix(sparsityPattern);
+        Vector<double> referenceRhs(dofHandler.n_dofs());
+        assemble_laplace_system(dofHandler, constraints, referenceMatrix, referenceRhs, source, coefficient, 0, false, false);
+
+        for (const AssemblyVariant& variant : variants)
+        {
+            SparseMatrix<double> matrix(sparsityPattern);
+            Vector<double> rhs(dofHandler.n_dofs());
+            assemble_laplace_system(dofHandler, constraints, matrix, rhs, source, coefficient, 0,
+                                    variant.specialized, variant.reuseCongruentCells);
+
+            matrix.add(-1., referenceMatrix);
+            rhs.add(-1., referenceRhs);
+            const double matrixError = matrix.frobenius_norm() / referenceMatrix.frobenius_norm();
+            const double rhsError = rhs.l2_norm() / referenceRhs.l2_norm();
+            const bool agrees = matrixError <= tolerance && rhsError <= tolerance;
+            passed = passed && agrees;
+
+            std::cout << std::left << std::setw(32) << gridName << " degree " << degree << "  " << std::setw(24)
+                      << variant.name << " matrix " << std::scientific << std::setprecision(2) << matrixError
+                      << "  rhs " << rhsError << (agrees ? "  ok" : "  FAILED") << std::endl;
+        }
+    }
+    return passed;
+}
+
+/**
+ *  @brief Main function that executes the check.
+ *
+ *  @return int 0 if all assembly paths agree, 1 otherwise.
+ */
+int main()
+{
+    bool passed = true;
+    {
+        Triangulation<2> triangulation;
+        HyperRectangle<2>({2, 1}).create_grid(triangulation, 3);
+        passed = checkGrid("2D rectangle", triangulation, false) && passed;
+        refineNearOrigin(triangulation, 2);
+        passed = checkGrid("2D locally refined rectangle", triangulation, false) && passed;
+        passed = checkGrid("2D rectangle with functions", triangulation, true) && passed;
+    }
+    {
+        Triangulation<2> triangulation;
+        HyperShell<2>({0.5, 1.0}).create_grid(triangulation, 1);
+        passed = checkGrid("2D shell", triangulation, false) && passed;
+        passed = checkGrid("2D shell with functions", triangulation, true) && passed;
+    }
+    {
+        Triangulation<3> triangulation;
+        HyperRectangle<3>({2, 1, 1}).create_grid(triangulation, 1);
+        passed = checkGrid("3D box", triangulation, false) && passed;
+        refineNearOrigin(triangulation, 1);
+        passed = checkGrid("3D locally refined box", triangulation, false) && passed;
+        passed = checkGrid("3D box with functions", triangulation, true) && passed;
+    }
+
+    std::cout << (passed ? "All assembly paths agree with the generic loop." : "Some assembly paths differ from the generic loop.")
+              << std::endl;
+    return passed ? 0 : 1;
+}
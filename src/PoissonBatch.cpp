@@ -0,0 +1,462 @@
+/**
+ *  \file PoissonBatch.cpp
+ *
+ *  PoissonBatch Execution File
+ *
+ *  Headless driver that solves many Poisson problems without the GUI. The problems are
+ *  read from a job file with one job per line:
+ *
+ *      # mesh     dimensions   refinement  degree  boundary  value
+ *      square2d   4 4          5           2       constant  1
+ *      square2d   4 4          5           2       distance  0
+ *      square3d   2 2 2        3           1       constant  2
+ *      radial     0.5 1.0      2           1       constant  1
+ *      radial3d   0.5 1.0      1           1       distance  0
+ *      mesh3d     device.msh   0           2       constant  1
+ *
+ *  The mesh is one of square2d, square3d, radial and radial3d, which expect two, three,
+ *  two and two dimensions like the GUI, or mesh2d and mesh3d, which expect the name of
+ *  a mesh file whose format is deduced from the extension, e.g. .msh for Gmsh. The
+ *  Dirichlet values are applied on boundary id 0 of the mesh file. The boundary is
+ *  either constant with the given value or distance for the squared Euclidian distance
+ *  to the origin. Empty lines and lines starting with # are ignored.
+ *
+ *  Usage: PoissonBatch <job file> [-j <parallel jobs>] [-o <output directory>] [-f <vtk|vtu|pvtu|hdf5>]
+ */
+
+// Include from the Poisson Solver Library
+#include "../lib/poisson.hpp"
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/base/utilities.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ *  @brief Structure for one Poisson problem of the job file.
+ */
+struct BatchJob
+{
+    unsigned int line = 0;                  //!< Line of the job in the job file
+    std::string mesh;                       //!< Mesh type: square2d, square3d, radial, radial3d, mesh2d or mesh3d
+    std::vector<double> dimensions;         //!< Dimensions of the domain
+    std::string meshFile;                   //!< Name of the mesh file of mesh2d and mesh3d
+    int refinement = 0;                     //!< Number of global refinements
+    int degree = 1;                         //!< Degree of the shape functions
+    bool constantBoundary = true;           //!< True for constant boundary values, false for the Euclidian distance
+    int boundaryValue = 0;                  //!< Value of the constant boundary condition
+};
+
+/**
+ *  @brief Structure for the outcome of one job.
+ */
+struct BatchResult
+{
+    bool success = false;                   //!< True if the job has been solved
+    double wallTime = 0.;                   //!< Wall time of the job in seconds
+    std::string outputFile;                 //!< Name of the written solution file
+    SolveStatistics statistics;             //!< Size and phase timing of the solve
+    std::string message;                    //!< Error message of a failed job
+};
+
+/**
+ *  @brief Function that reads all jobs from the job file.
+ *
+ *  @param fileName Name of the job file.
+ *  @return Jobs in the order of the file.
+ *
+ *  Throws a std::runtime_error with the line number if a job can not be parsed.
+ */
+std::vector<BatchJob> readJobFile(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+    if (!file)
+        throw std::runtime_error("Could not open the job file " + fileName);
+
+    std::vector<BatchJob> jobs;
+    std::string lineString;
+    for (unsigned int line = 1; std::getline(file, lineString); ++line)
+    {
+        std::istringstream stream(lineString);
+        BatchJob job;
+        job.line = line;
+        if (!(stream >> job.mesh) || job.mesh[0] == '#')
+            continue;
+
+        unsigned int numberOfDimensions = 0;
+        if (job.mesh == "square2d" || job.mesh == "radial" || job.mesh == "radial3d")
+            numberOfDimensions = 2;
+        else if (job.mesh == "square3d")
+            numberOfDimensions = 3;
+        else if (job.mesh != "mesh2d" && job.mesh != "mesh3d")
+            throw std::runtime_error("Line " + std::to_string(line) + ": unknown mesh type " + job.mesh);
+
+        if (numberOfDimensions == 0)
+            stream >> job.meshFile;
+        job.dimensions.resize(numberOfDimensions);
+        for (double& dimension : job.dimensions)
+            stream >> dimension;
+
+        std::string boundary;
+        stream >> job.refinement >> job.degree >> boundary >> job.boundaryValue;
+        if (!stream)
+            throw std::runtime_error("Line " + std::to_string(line) + ": expected "
+                                     + (numberOfDimensions == 0 ? std::string("a mesh file") : std::to_string(numberOfDimensions) + " dimensions")
+                                     + ", refinement, degree, boundary and value");
+
+        if (boundary != "constant" && boundary != "distance")
+            throw std::runtime_error("Line " + std::to_string(line) + ": unknown boundary " + boundary);
+        job.constantBoundary = (boundary == "constant");
+
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+/**
+ *  @brief Function that solves one job on the given geometry.
+ *
+ *  @param geometry Geometry policy that creates the grid of the job.
+ *  @param job Job to solve.
+ *  @param options Solver options with the output settings of all jobs.
+ *  @param result Receives the statistics and the output file of the job.
+ */
+template <int dim, class Geometry>
+void solveJob(const Geometry& geometry, const BatchJob& job, const SolverOptions& options, BatchResult& result)
+{
+    PoissonProblem<dim, Geometry> problem(geometry, job.refinement, job.degree, job.boundaryValue, job.constantBoundary, options);
+    result.statistics = problem.run();
+    result.outputFile = problem.last_output_file();
+}
+
+/**
+ *  @brief Function that solves one job.
+ *
+ *  @param job Job to solve.
+ *  @param options Solver options with the output settings of all jobs.
+ *  @return Wall time and output file of the job, or the error message if it failed.
+ */
+BatchResult runJob(const BatchJob& job, const SolverOptions& options)
+{
+    BatchResult result;
+    Timer timer;
+    try
+    {
+        const std::vector<int> intDimensions(job.dimensions.begin(), job.dimensions.end());
+        if (job.mesh == "radial")
+            solveJob<2>(HyperShell<2>(job.dimensions), job, options, result);
+        else if (job.mesh == "radial3d")
+            solveJob<3>(HyperShell<3>(job.dimensions), job, options, result);
+        else if (job.mesh == "square2d")
+            solveJob<2>(HyperRectangle<2>(intDimensions), job, options, result);
+        else if (job.mesh == "square3d")
+            solveJob<3>(HyperRectangle<3>(intDimensions), job, options, result);
+        else if (job.mesh == "mesh2d")
+            solveJob<2>(ImportedMesh<2>(job.meshFile), job, options, result);
+        else
+            solveJob<3>(ImportedMesh<3>(job.meshFile), job, options, result);
+        result.success = true;
+    }
+    catch (const std::exception& exception)
+    {
+        result.message = exception.what();
+    }
+    result.wallTime = timer.wall_time();
+    return result;
+}
+
+/**
+ *  @brief Function that writes the result of a job to a pipe.
+ *
+ *  @param pipe Write end of the pipe to the parent process.
+ *  @param result Result of the job.
+ *
+ *  The statistics are written as raw bytes, followed by the output file and the error
+ *  message with their lengths. The message is shortened, so the result always fits into
+ *  the buffer of the pipe and the child process never blocks before it exits.
+ */
+void writeResult(int pipe, const BatchResult& result)
+{
+    static_assert(std::is_trivially_copyable<SolveStatistics>::value, "SolveStatistics is sent as raw bytes");
+
+    std::ostringstream stream;
+    const std::string message = result.message.substr(0, 1024);
+    const std::size_t outputFileLength = result.outputFile.size(), messageLength = message.size();
+    stream.write(reinterpret_cast<const char*>(&result.success), sizeof(result.success));
+    stream.write(reinterpret_cast<const char*>(&result.wallTime), sizeof(result.wallTime));
+    stream.write(reinterpret_cast<const char*>(&result.statistics), sizeof(result.statistics));
+    stream.write(reinterpret_cast<const char*>(&outputFileLength), sizeof(outputFileLength));
+    stream << result.outputFile;
+    stream.write(reinterpret_cast<const char*>(&messageLength), sizeof(messageLength));
+    stream << message;
+
+    const std::string data = stream.str();
+    for (std::size_t written = 0; written < data.size();)
+    {
+        const ssize_t count = write(pipe, data.data() + written, data.size() - written);
+        if (count <= 0)
+            break;
+        written += count;
+    }
+}
+
+/**
+ *  @brief Function that reads the result of a job from the pipe of its child process.
+ *
+ *  @param pipe Read end of the pipe from the child process.
+ *  @return Result of the job, a failed result if the child process has not written it.
+ */
+BatchResult readResult(int pipe)
+{
+    std::string data;
+    char buffer[4096];
+    for (ssize_t count; (count = read(pipe, buffer, sizeof(buffer))) > 0;)
+        data.append(buffer, count);
+
+    BatchResult result;
+    std::istringstream stream(data);
+    std::size_t outputFileLength = 0, messageLength = 0;
+    stream.read(reinterpret_cast<char*>(&result.success), sizeof(result.success));
+    stream.read(reinterpret_cast<char*>(&result.wallTime), sizeof(result.wallTime));
+    stream.read(reinterpret_cast<char*>(&result.statistics), sizeof(result.statistics));
+    stream.read(reinterpret_cast<char*>(&outputFileLength), sizeof(outputFileLength));
+    if (!stream)
+        return BatchResult{false, 0., "", SolveStatistics(), "the job process has been terminated"};
+    result.outputFile.resize(outputFileLength);
+    stream.read(&result.outputFile[0], outputFileLength);
+    stream.read(reinterpret_cast<char*>(&messageLength), sizeof(messageLength));
+    result.message.resize(messageLength);
+    stream.read(&result.message[0], messageLength);
+    return result;
+}
+
+/**
+ *  @brief Structure for a job that is solved by a child process.
+ */
+struct JobProcess
+{
+    std::size_t job = 0;                    //!< Index of the job
+    int pipe = -1;                          //!< Read end of the pipe with the result of the job
+};
+
+/**
+ *  @brief Function that solves one job in a new child process.
+ *
+ *  @param argc Argument counter for the initialization of MPI in the child process.
+ *  @param argv Argument vector for the initialization of MPI in the child process.
+ *  @param job Job to solve.
+ *  @param options Solver options with the output settings of the job.
+ *  @param threads Number of threads of the child process.
+ *  @return Process id of the child process, the read end of its pipe is stored in process.
+ *
+ *  The child process initializes MPI for itself, so the MPI calls of the timers and of
+ *  the pvtu and hdf5 writers never run concurrently within one process.
+ */
+pid_t startJobProcess(int argc, char** argv, const BatchJob& job, const SolverOptions& options, unsigned int threads,
+                      JobProcess& process)
+{
+    int pipeEnds[2];
+    if (pipe(pipeEnds) != 0)
+        throw std::runtime_error("Could not create a pipe for a job process");
+
+    // Output that is still buffered would otherwise be written by both processes
+    std::cout.flush();
+    const pid_t pid = fork();
+    if (pid < 0)
+        throw std::runtime_error("Could not start a job process");
+    if (pid == 0)
+    {
+        close(pipeEnds[0]);
+        int status = 1;
+        {
+            Utilities::MPI::MPI_InitFinalize mpiInitialization(argc, argv, threads);
+            const BatchResult result = runJob(job, options);
+            writeResult(pipeEnds[1], result);
+            status = result.success ? 0 : 1;
+        }
+        close(pipeEnds[1]);
+        std::cout.flush();
+        _exit(status);
+    }
+
+    close(pipeEnds[1]);
+    process.pipe = pipeEnds[0];
+    return pid;
+}
+
+/**
+ *  @brief Function that writes the timing summary of all jobs.
+ *
+ *  @param output Stream the summary is written to.
+ *  @param jobs Jobs of the job file.
+ *  @param results Results in the order of the jobs.
+ *  @param totalTime Wall time of the whole batch in seconds.
+ */
+void writeSummary(std::ostream& output, const std::vector<BatchJob>& jobs, const std::vector<BatchResult>& results,
+                  double totalTime)
+{
+    double jobTime = 0.;
+    unsigned int failed = 0;
+    output << std::left << std::setw(6) << "job" << std::setw(6) << "line" << std::setw(10) << "mesh"
+           << std::setw(12) << "refinement" << std::setw(8) << "degree" << std::setw(10) << "dofs" << std::setw(8) << "cg"
+           << std::setw(12) << "solve [s]" << std::setw(12) << "time [s]" << "result" << std::endl;
+    for (std::size_t i = 0; i < jobs.size(); ++i)
+    {
+        output << std::left << std::setw(6) << i << std::setw(6) << jobs[i].line << std::setw(10) << jobs[i].mesh
+               << std::setw(12) << jobs[i].refinement << std::setw(8) << jobs[i].degree
+               << std::setw(10) << results[i].statistics.n_dofs << std::setw(8) << results[i].statistics.cg_iterations
+               << std::setw(12) << std::fixed << std::setprecision(3) << results[i].statistics.solve_time
+               << std::setw(12) << std::fixed << std::setprecision(3) << results[i].wallTime
+               << (results[i].success ? results[i].outputFile : "failed: " + results[i].message) << std::endl;
+        jobTime += results[i].wallTime;
+        failed += results[i].success ? 0 : 1;
+    }
+    output << std::endl << jobs.size() << " jobs, " << failed << " failed, " << std::fixed << std::setprecision(3)
+           << jobTime << " s of job time in " << totalTime << " s of wall time" << std::endl;
+}
+
+/**
+ *  @brief Main function that executes the batch.
+ *
+ *  @param argc Argument counter.
+ *  @param argv Argument vector with the job file and the options.
+ *  @return int 0 if all jobs have been solved, 1 otherwise.
+ *
+ *  With one parallel job the jobs are solved one after the other in this process. Otherwise
+ *  every job is solved by a child process and a new one is started whenever a job has
+ *  finished, so jobs of different size keep all cores busy. The timers and the pvtu and
+ *  hdf5 writers call MPI, which is initialized for serialized calls only, and HDF5 is not
+ *  thread safe, so parallel jobs do not share a process. MPI_InitFinalize limits the
+ *  threads of deal.II and TBB for the whole process: every job process gets an equal share
+ *  of the cores, at least one thread. The solutions are named after the number of the job
+ *  and the summary is written to the output directory.
+ */
+int main(int argc, char** argv)
+{
+    std::string jobFileName;
+    std::string outputDirectory = "./";
+    std::string format = "vtu";
+    unsigned int parallelJobs = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        if (argument == "-j" && i + 1 < argc)
+            parallelJobs = std::max(1, std::stoi(argv[++i]));
+        else if (argument == "-o" && i + 1 < argc)
+            outputDirectory = argv[++i];
+        else if (argument == "-f" && i + 1 < argc)
+            format = argv[++i];
+        else
+            jobFileName = argument;
+    }
+    if (jobFileName.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " <job file> [-j <parallel jobs>] [-o <output directory>] [-f <vtk|vtu|pvtu|hdf5>]"
+                  << std::endl;
+        return 1;
+    }
+    if (outputDirectory.back() != '/')
+        outputDirectory += '/';
+
+    SolverOptions options;
+    options.preconditioner = PreconditionerType::multigrid;
+    options.output_directory = outputDirectory;
+    if (format == "vtk")
+        options.output_format = OutputFormat::vtk;
+    else if (format == "vtu")
+        options.output_format = OutputFormat::vtu;
+    else if (format == "pvtu")
+        options.output_format = OutputFormat::pvtu;
+    else if (format == "hdf5")
+        options.output_format = OutputFormat::hdf5;
+    else
+    {
+        std::cerr << "Unknown output format " << format << std::endl;
+        return 1;
+    }
+
+    std::vector<BatchJob> jobs;
+    try
+    {
+        jobs = readJobFile(jobFileName);
+    }
+    catch (const std::exception& exception)
+    {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<BatchResult> results(jobs.size());
+    const auto jobOptions = [&options](std::size_t i)
+    {
+        SolverOptions jobOptions = options;
+        jobOptions.output_name = "job-" + Utilities::int_to_string(i, 4);
+        return jobOptions;
+    };
+    Timer timer;
+
+    if (parallelJobs == 1)
+    {
+        Utilities::MPI::MPI_InitFinalize mpiInitialization(argc, argv, numbers::invalid_unsigned_int);
+        for (std::size_t i = 0; i < jobs.size(); ++i)
+            results[i] = runJob(jobs[i], jobOptions(i));
+    }
+    else
+    {
+        // This process only starts the job processes and collects their results, it does not initialize MPI
+        const unsigned int threads = std::max(1u, std::thread::hardware_concurrency() / parallelJobs);
+        std::map<pid_t, JobProcess> running;
+        std::size_t nextJob = 0;
+        while (nextJob < jobs.size() || !running.empty())
+        {
+            if (nextJob < jobs.size() && running.size() < parallelJobs)
+            {
+                JobProcess process;
+                process.job = nextJob;
+                try
+                {
+                    const pid_t pid = startJobProcess(argc, argv, jobs[nextJob], jobOptions(nextJob), threads, process);
+                    running[pid] = process;
+                }
+                catch (const std::exception& exception)
+                {
+                    results[nextJob].message = exception.what();
+                }
+                ++nextJob;
+                continue;
+            }
+
+            int status = 0;
+            const pid_t pid = waitpid(-1, &status, 0);
+            const auto process = running.find(pid);
+            if (process == running.end())
+                continue;
+            results[process->second.job] = readResult(process->second.pipe);
+            close(process->second.pipe);
+            running.erase(process);
+        }
+    }
+
+    const double totalTime = timer.wall_time();
+    writeSummary(std::cout, jobs, results, totalTime);
+    std::ofstream summary(outputDirectory + "batch-summary.txt");
+    writeSummary(summary, jobs, results, totalTime);
+
+    return std::all_of(results.begin(), results.end(), [](const BatchResult& result) { return result.success; }) ? 0 : 1;
+}
@@ -0,0 +1,393 @@
+/**
+ *  \file PoissonBenchmark.cpp
+ *
+ *  PoissonBenchmark Execution File
+ *
+ *  Benchmark of the Poisson Solver Library. Poisson<2>, Poisson<3> and Radial_Poisson are
+ *  solved for a range of refinements and shape function orders, and the wall time of every
+ *  phase is measured separately. The results are written as CSV with one line per case, so
+ *  they can be compared between builds. With a baseline file the cases that became slower
+ *  than the tolerance are reported and the benchmark fails. The generic_assembly and
+ *  specialized_assembly cases repeat the default cases of every degree without the reuse of
+ *  congruent cells, with the generic loop and with the specialized FE_Q kernels. Their
+ *  assembly_s column is the reference for the kernels and for the reuse of the default cases.
+ *  The mixed_precision cases repeat the largest 3D case of every degree with single precision
+ *  CG iterations, their solve_s column is compared with the one of the default cases. With
+ *  UMFPACK the direct cases solve one large 2D case of every degree with the LU factorization.
+ *  Every case runs in its own process, so memory_kb and peak_memory_kb belong to the case:
+ *  they contain the memory of the case and the constant memory of the loaded libraries.
+ *
+ *  Usage: PoissonBenchmark [-o <results.csv>] [-b <baseline.csv>] [-t <tolerance>] [-r <repetitions>] [--quick]
+ */
+
+// Include from the Poisson Solver Library
+#include "../lib/poisson.hpp"
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/utilities.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ *  @brief Structure for one benchmark case.
+ */
+struct BenchmarkCase
+{
+    std::string problem;                    //!< Problem type: square2d, square3d or radial
+    int refinement = 0;                     //!< Number of global refinements, the radial grid refines its inner boundary three more times
+    int degree = 1;                         //!< Degree of the shape functions
+    std::string variant = "default";        //!< Name of the solver options of the case
+    SolverOptions options;                  //!< Solver options of the case
+};
+
+/**
+ *  @brief Structure for the measurements of one benchmark case.
+ */
+struct BenchmarkResult
+{
+    SolveStatistics statistics;             //!< Phase times, size, CG iterations and peak memory of the case process returned by run()
+    std::size_t memory = 0;                 //!< Resident memory of the case process after the solve in kB
+
+    /**
+     *  @brief Function that returns the wall time of all phases.
+     *
+     *  @return Total wall time in seconds.
+     */
+    double totalTime() const
+    {
+        return statistics.total_time();
+    }
+};
+
+/**
+ *  @brief Function that reads the resident memory of the process.
+ *
+ *  @return Resident memory in kB.
+ *
+ *  Is called while the problem still exists, so the resident memory includes the grid,
+ *  the system and the preconditioner of the case.
+ */
+std::size_t residentMemory()
+{
+    Utilities::System::MemoryStats memoryStats;
+    Utilities::System::get_memory_stats(memoryStats);
+    return memoryStats.VmRSS;
+}
+
+/**
+ *  @brief Function that solves one benchmark case and measures it.
+ *
+ *  @param benchmarkCase Case to solve.
+ *  @return Timing, size and memory of the case.
+ *
+ *  The phase times, the number of CG iterations and the peak memory are the statistics
+ *  that run() returns, so the benchmark reports the same numbers as the solver itself.
+ */
+BenchmarkResult runCase(const BenchmarkCase& benchmarkCase)
+{
+    SolverOptions options = benchmarkCase.options;
+    options.output_format = OutputFormat::vtu;
+    options.output_name = "benchmark-solution";
+
+    BenchmarkResult result;
+    if (benchmarkCase.problem == "radial")
+    {
+        Radial_Poisson problem({0.5, 1.0}, benchmarkCase.refinement, benchmarkCase.degree, 1, options);
+        result.statistics = problem.run();
+        result.memory = residentMemory();
+    }
+    else if (benchmarkCase.problem == "square2d")
+    {
+        Poisson<2> problem({1, 1}, benchmarkCase.refinement, benchmarkCase.degree, 0, false, options);
+        result.statistics = problem.run();
+        result.memory = residentMemory();
+    }
+    else
+    {
+        Poisson<3> problem({1, 1, 1}, benchmarkCase.refinement, benchmarkCase.degree, 0, false, options);
+        result.statistics = problem.run();
+        result.memory = residentMemory();
+    }
+    return result;
+}
+
+/**
+ *  @brief Function that runs all repetitions of a case in a child process.
+ *
+ *  @param argc Argument counter for the initialization of MPI in the child process.
+ *  @param argv Argument vector for the initialization of MPI in the child process.
+ *  @param benchmarkCase Case to solve.
+ *  @param repetitions Number of runs of the case.
+ *  @return Measurements of the fastest run.
+ *
+ *  The peak resident memory of a process never decreases, so in one process every case
+ *  after the largest one would report the peak of the largest one. The child process only
+ *  solves this case, its peak memory is the one of the case. The result is sent back
+ *  through a pipe, a std::runtime_error is thrown if the case has failed.
+ */
+BenchmarkResult runCaseProcess(int argc, char** argv, const BenchmarkCase& benchmarkCase, unsigned int repetitions)
+{
+    static_assert(std::is_trivially_copyable<BenchmarkResult>::value, "BenchmarkResult is sent as raw bytes");
+
+    int pipeEnds[2];
+    if (pipe(pipeEnds) != 0)
+        throw std::runtime_error("Could not create a pipe for a benchmark process");
+
+    // Output that is still buffered would otherwise be written by both processes
+    std::cout.flush();
+    const pid_t pid = fork();
+    if (pid < 0)
+        throw std::runtime_error("Could not start a benchmark process");
+    if (pid == 0)
+    {
+        close(pipeEnds[0]);
+        int status = 1;
+        try
+        {
+            Utilities::MPI::MPI_InitFinalize mpiInitialization(argc, argv);
+            BenchmarkResult best;
+            for (unsigned int repetition = 0; repetition < repetitions; ++repetition)
+            {
+                const BenchmarkResult result = runCase(benchmarkCase);
+                if (repetition == 0 || result.totalTime() < best.totalTime())
+                    best = result;
+            }
+            if (write(pipeEnds[1], &best, sizeof(best)) == static_cast<ssize_t>(sizeof(best)))
+                status = 0;
+        }
+        catch (const std::exception& exception)
+        {
+            std::cerr << exception.what() << std::endl;
+        }
+        close(pipeEnds[1]);
+        std::cout.flush();
+        _exit(status);
+    }
+
+    close(pipeEnds[1]);
+    BenchmarkResult result;
+    std::size_t received = 0;
+    for (ssize_t count; received < sizeof(result) &&
+                        (count = read(pipeEnds[0], reinterpret_cast<char*>(&result) + received, sizeof(result) - received)) > 0;)
+        received += count;
+    close(pipeEnds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (received != sizeof(result))
+        throw std::runtime_error("The benchmark case " + benchmarkCase.problem + " " + std::to_string(benchmarkCase.refinement) +
+                                 " " + std::to_string(benchmarkCase.degree) + " " + benchmarkCase.variant + " has failed");
+    return result;
+}
+
+/**
+ *  @brief Function that returns the cases of the benchmark.
+ *
+ *  @param quick If true, the largest refinements are left out.
+ *  @return Cases ordered by problem, refinement and degree, followed by the renumbering and assembly variants.
+ *
+ *  The renumbering variants repeat one large 2D and 3D case with every order of the
+ *  degrees of freedom, the default cases use the order of distribute_dofs(). The assembly
+ *  variants repeat the largest 2D and 3D case of every degree with every cell computed, once
+ *  with the generic assembly loop and once with the specialized kernels. The mixed precision
+ *  variants repeat the largest 3D case of every degree, the direct variants one 2D case of
+ *  every degree if deal.II has UMFPACK.
+ */
+std::vector<BenchmarkCase> benchmarkCases(bool quick)
+{
+    std::vector<BenchmarkCase> cases;
+    const int reduction = quick ? 2 : 0;
+    for (int degree = 1; degree <= 3; ++degree)
+    {
+        for (int refinement = 4; refinement <= 8 - reduction; ++refinement)
+            cases.push_back({"square2d", refinement, degree});
+        for (int refinement = 2; refinement <= 5 - reduction - (degree > 1 ? 1 : 0); ++refinement)
+            cases.push_back({"square3d", refinement, degree});
+        for (int refinement = 2; refinement <= 6 - reduction; ++refinement)
+            cases.push_back({"radial", refinement, degree});
+    }
+
+    // The order of the degrees of freedom changes the memory access pattern of every CG iteration
+    const std::vector<std::pair<std::string, RenumberingType>> renumberings = {
+        {"cuthill_mckee", RenumberingType::cuthill_mckee},
+        {"reverse_cuthill_mckee", RenumberingType::reverse_cuthill_mckee},
+        {"hierarchical", RenumberingType::hierarchical}};
+    for (const auto& renumbering : renumberings)
+    {
+        BenchmarkCase square2d{"square2d", 8 - reduction, 2, renumbering.first};
+        square2d.options.renumbering = renumbering.second;
+        cases.push_back(square2d);
+
+        BenchmarkCase square3d{"square3d", 4 - reduction, 2, renumbering.first};
+        square3d.options.renumbering = renumbering.second;
+        cases.push_back(square3d);
+    }
+
+    // The generic loop has run time trip counts, the specialized kernels are selected by degree and dimension
+    const std::vector<std::pair<std::string, bool>> kernels = {{"generic_assembly", false}, {"specialized_assembly", true}};
+    for (const auto& kernel : kernels)
+    {
+        for (int degree = 1; degree <= 3; ++degree)
+        {
+            BenchmarkCase square2d{"square2d", 8 - reduction, degree, kernel.first};
+            square2d.options.specialized_assembly = kernel.second;
+            square2d.options.reuse_congruent_cells = false;
+            cases.push_back(square2d);
+
+            BenchmarkCase square3d{"square3d", 5 - reduction - (degree > 1 ? 1 : 0), degree, kernel.first};
+            square3d.options.specialized_assembly = kernel.second;
+            square3d.options.reuse_congruent_cells = false;
+            cases.push_back(square3d);
+        }
+    }
+
+    // The CG iterations of large 3D cases are limited by the memory bandwidth
+    for (int degree = 1; degree <= 3; ++degree)
+    {
+        BenchmarkCase square3d{"square3d", 5 - reduction - (degree > 1 ? 1 : 0), degree, "mixed_precision"};
+        square3d.options.mixed_precision = true;
+        cases.push_back(square3d);
+    }
+
+#ifdef DEAL_II_WITH_UMFPACK
+    // The factorization includes the fill-in, its memory shows in memory_kb and peak_memory_kb of the case process
+    for (int degree = 1; degree <= 3; ++degree)
+    {
+        BenchmarkCase square2d{"square2d", 7 - reduction, degree, "direct"};
+        square2d.options.linear_solver = LinearSolverType::direct;
+        cases.push_back(square2d);
+    }
+#endif
+
+    // The multigrid preconditioner keeps the number of CG iterations independent of the refinement
+    for (BenchmarkCase& benchmarkCase : cases)
+        benchmarkCase.options.preconditioner = PreconditionerType::multigrid;
+    return cases;
+}
+
+/**
+ *  @brief Function that returns the key of a case in the CSV files.
+ *
+ *  @param problem Problem type.
+ *  @param refinement Number of refinements.
+ *  @param degree Degree of the shape functions.
+ *  @param variant Name of the solver options.
+ *  @return Key of the case.
+ */
+std::string caseKey(const std::string& problem, int refinement, int degree, const std::string& variant)
+{
+    return problem + "," + std::to_string(refinement) + "," + std::to_string(degree) + "," + variant;
+}
+
+/**
+ *  @brief Function that reads the total times of a previous benchmark.
+ *
+ *  @param fileName Name of the CSV file written by a previous benchmark.
+ *  @return Total time in seconds for every case key.
+ */
+std::map<std::string, double> readBaseline(const std::string& fileName)
+{
+    std::map<std::string, double> baseline;
+    std::ifstream file(fileName);
+    std::string line;
+    std::getline(file, line); // header
+    while (std::getline(file, line))
+    {
+        std::vector<std::string> fields;
+        std::istringstream stream(line);
+        for (std::string field; std::getline(stream, field, ',');)
+            fields.push_back(field);
+        if (fields.size() > 10)
+            baseline[caseKey(fields[0], std::stoi(fields[1]), std::stoi(fields[2]), fields[3])] = std::stod(fields[10]);
+    }
+    return baseline;
+}
+
+/**
+ *  @brief Main function that executes the benchmark.
+ *
+ *  @param argc Argument counter.
+ *  @param argv Argument vector with the options.
+ *  @return int 0 if no case is slower than the baseline, 1 otherwise.
+ *
+ *  Every case is run the given number of times and the fastest run is kept, which
+ *  removes most of the noise of a shared machine. The cases run one after the other,
+ *  each in its own child process. This process does not initialize MPI.
+ */
+int main(int argc, char** argv)
+{
+    std::string outputFileName = "benchmark.csv";
+    std::string baselineFileName;
+    double tolerance = 0.1;
+    unsigned int repetitions = 3;
+    bool quick = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        if (argument == "-o" && i + 1 < argc)
+            outputFileName = argv[++i];
+        else if (argument == "-b" && i + 1 < argc)
+            baselineFileName = argv[++i];
+        else if (argument == "-t" && i + 1 < argc)
+            tolerance = std::stod(argv[++i]);
+        else if (argument == "-r" && i + 1 < argc)
+            repetitions = std::max(1, std::stoi(argv[++i]));
+        else if (argument == "--quick")
+            quick = true;
+        else
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [-o <results.csv>] [-b <baseline.csv>] [-t <tolerance>] [-r <repetitions>] [--quick]" << std::endl;
+            return 1;
+        }
+    }
+
+    const std::map<std::string, double> baseline =
+        baselineFileName.empty() ? std::map<std::string, double>() : readBaseline(baselineFileName);
+
+    std::ofstream output(outputFileName);
+    output << "problem,refinement,degree,variant,dofs,grid_s,setup_s,assembly_s,solve_s,output_s,total_s,"
+           << "dofs_per_s,cg_iterations,memory_kb,peak_memory_kb" << std::endl;
+
+    unsigned int regressions = 0;
+    for (const BenchmarkCase& benchmarkCase : benchmarkCases(quick))
+    {
+        const BenchmarkResult best = runCaseProcess(argc, argv, benchmarkCase, repetitions);
+
+        const std::string key = caseKey(benchmarkCase.problem, benchmarkCase.refinement, benchmarkCase.degree,
+                                        benchmarkCase.variant);
+        const SolveStatistics& statistics = best.statistics;
+        output << key << "," << statistics.n_dofs << "," << statistics.grid_time << "," << statistics.setup_time << ","
+               << statistics.assembly_time << "," << statistics.solve_time << "," << statistics.output_time;
+        output << "," << best.totalTime() << "," << statistics.n_dofs / best.totalTime() << "," << statistics.cg_iterations
+               << "," << best.memory << "," << statistics.peak_memory << std::endl;
+
+        std::cout << key << ": " << statistics.n_dofs << " DoFs in " << best.totalTime() << " s ("
+                  << statistics.n_dofs / best.totalTime() << " DoFs/s)";
+        const auto reference = baseline.find(key);
+        if (reference != baseline.end() && best.totalTime() > (1. + tolerance) * reference->second)
+        {
+            std::cout << "  REGRESSION, baseline " << reference->second << " s";
+            ++regressions;
+        }
+        std::cout << std::endl;
+    }
+
+    if (regressions > 0)
+        std::cout << regressions << " cases are more than " << 100. * tolerance << "% slower than the baseline." << std::endl;
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+/**
+ *  \file PoissonMPI.cpp
+ *
+ *  PoissonMPI Execution File
+ *
+ *  Solves the Poisson equation on a 3D hyper rectangle with several MPI processes, e.g.
+ *
+ *      mpirun -np 4 PoissonMPI -d 2 2 2 -r 6 -p 2 -b 1
+ *
+ *  Options: -d <x> <y> <z> dimensions, -r <refinement>, -p <shape function order>,
+ *  -b <constant boundary value> or --distance for the squared Euclidian distance,
+ *  -o <output directory> and --timings for the table of the phase timings.
+ */
+
+// Include from the Poisson Solver Library
+#include "../lib/distributed_poisson.hpp"
+
+#include <deal.II/base/mpi.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ *  @brief Main function that executes the distributed solve.
+ *
+ *  @param argc Argument counter.
+ *  @param argv Argument vector with the options.
+ *  @return int 0 if the problem has been solved, 1 otherwise.
+ *
+ *  Every process runs the same program, the triangulation, the degrees of freedom and
+ *  the vectors are split between the processes of MPI_COMM_WORLD. Each process uses one
+ *  thread, so the parallelism comes from the processes.
+ */
+int main(int argc, char** argv)
+{
+    Utilities::MPI::MPI_InitFinalize mpiInitialization(argc, argv, 1);
+    const bool firstProcess = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0;
+
+    std::vector<int> dimensions = {1, 1, 1};
+    int refinementLevel = 5, shapeFunctionOrder = 1, boundaryValue = 1;
+    bool homogeneous = true;
+    SolverOptions options;
+    options.output_format = OutputFormat::pvtu;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        if (argument == "-d" && i + 3 < argc)
+        {
+            for (int& dimension : dimensions)
+                dimension = std::stoi(argv[++i]);
+        }
+        else if (argument == "-r" && i + 1 < argc)
+            refinementLevel = std::stoi(argv[++i]);
+        else if (argument == "-p" && i + 1 < argc)
+            shapeFunctionOrder = std::stoi(argv[++i]);
+        else if (argument == "-b" && i + 1 < argc)
+            boundaryValue = std::stoi(argv[++i]);
+        else if (argument == "--distance")
+            homogeneous = false;
+        else if (argument == "-o" && i + 1 < argc)
+            options.output_directory = std::string(argv[++i]) + "/";
+        else if (argument == "--timings")
+            options.print_timings = true;
+        else
+        {
+            if (firstProcess)
+                std::cerr << "Usage: mpirun -np <processes> " << argv[0]
+                          << " [-d <x> <y> <z>] [-r <refinement>] [-p <order>] [-b <value> | --distance] [-o <directory>] [--timings]"
+                          << std::endl;
+            return 1;
+        }
+    }
+
+    try
+    {
+        DistributedPoisson<3> poissonProblem(MPI_COMM_WORLD, dimensions, refinementLevel, shapeFunctionOrder,
+                                             boundaryValue, homogeneous, options);
+        const SolveStatistics statistics = poissonProblem.run();
+        if (firstProcess)
+            std::cout << "   Solved " << statistics.n_dofs << " degrees of freedom in " << statistics.total_time()
+                      << " s, peak memory per process " << statistics.peak_memory / 1024 << " MB." << std::endl;
+    }
+    catch (const std::exception& exception)
+    {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+/**
+ *  \file ProblemCache.hpp
+ *
+ *  ProblemCache Class Header File
+ */
+
+#pragma once
+
+// Includes from the QT Library
+#include <QString>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+
+/**
+ *  @brief Structure for the parameters that determine the grid and the assembled system of a Poisson object.
+ *
+ *  The boundary values are not part of the key, since a solved Poisson object can be
+ *  solved again for other boundary values without a new grid or assembly.
+ */
+struct ProblemKey
+{
+    QString meshType;                   //!< Type of the mesh as selected in the GUI
+    std::vector<double> dimensions;     //!< Dimensions of the mesh
+    int refinement = 0;                 //!< Refinement level of the mesh
+    int shapeFunction = 0;              //!< Shape function order
+    QString preconditioner;             //!< Preconditioner of the CG solver
+
+    /**
+     *  @brief Function that compares two keys.
+     *
+     *  @param other Key to compare with.
+     *  @return True if all parameters are equal.
+     */
+    bool operator==(const ProblemKey& other) const
+    {
+        return meshType == other.meshType && dimensions == other.dimensions && refinement == other.refinement &&
+               shapeFunction == other.shapeFunction && preconditioner == other.preconditioner;
+    }
+};
+
+/**
+ *  @brief Class for the least recently used cache of solved Poisson objects.
+ *
+ *  Every Poisson object keeps its grid, degrees of freedom, sparsity pattern, assembled
+ *  matrix and preconditioner, so going back to a recent configuration only needs a new
+ *  solve. The objects are stored type erased, the mesh type in the key determines the
+ *  class of the object. If the memory of all objects exceeds the limit, the least
+ *  recently used ones are freed, but the most recent one is always kept. The memory of
+ *  a cached object grows with re-solves, e.g. by the stored solutions for the initial
+ *  guess, so all objects are measured again whenever one is inserted. The limit only
+ *  bounds the memory if the owner releases its own references to evicted objects, see
+ *  contains().
+ */
+class ProblemCache
+{
+private:
+    /**
+     *  @brief Structure for one cached Poisson object.
+     */
+    struct Entry
+    {
+        ProblemKey key;                 //!< Parameters of the Poisson object
+        std::shared_ptr<void> problem;  //!< Poisson object of the class given by the mesh type
+        std::function<std::size_t()> memory; //!< Returns the current memory used by the Poisson object in bytes
+    };
+
+    std::list<Entry> entries;           //!< Cached objects, most recently used first
+    std::size_t memoryLimit;            //!< Maximum memory of all cached objects in bytes
+
+public:
+    /**
+     *  @brief Constructor for the ProblemCache class.
+     *
+     *  @param limit Maximum memory of all cached objects in bytes.
+     *  @return New ProblemCache class object.
+     */
+    ProblemCache(std::size_t limit) : memoryLimit(limit) {}
+
+    /**
+     *  @brief Function that looks up a Poisson object and marks it as most recently used.
+     *
+     *  @param key Parameters of the Poisson object.
+     *  @return Cached Poisson object, nullptr if there is none for the key.
+     */
+    template <class Problem>
+    std::shared_ptr<Problem> find(const ProblemKey& key)
+    {
+        for (auto entry = entries.begin(); entry != entries.end(); ++entry)
+        {
+            if (entry->key == key)
+            {
+                entries.splice(entries.begin(), entries, entry);
+                return std::static_pointer_cast<Problem>(entries.front().problem);
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     *  @brief Function that adds a solved Poisson object as most recently used.
+     *
+     *  @param key Parameters of the Poisson object.
+     *  @param problem Solved Poisson object.
+     *
+     *  An older object with the same key is replaced. Afterwards the memory of all objects
+     *  is read with memory_consumption() and the least recently used objects are freed
+     *  until the memory limit is met.
+     */
+    template <class Problem>
+    void insert(const ProblemKey& key, std::shared_ptr<Problem> problem)
+    {
+        entries.remove_if([&key](const Entry& entry) { return entry.key == key; });
+        const Problem* object = problem.get();
+        entries.push_front({key, std::move(problem), [object] { return object->memory_consumption(); }});
+
+        std::vector<std::size_t> memory;
+        std::size_t totalMemory = 0;
+        for (const Entry& entry : entries)
+        {
+            memory.push_back(entry.memory());
+            totalMemory += memory.back();
+        }
+        while (entries.size() > 1 && totalMemory > memoryLimit)
+        {
+            totalMemory -= memory.back();
+            memory.pop_back();
+            entries.pop_back();
+        }
+    }
+
+    /**
+     *  @brief Function that checks if a Poisson object is still cached.
+     *
+     *  @param problem Poisson object, e.g. one that was returned by find().
+     *  @return True if the object has not been evicted.
+     */
+    template <class Problem>
+    bool contains(const std::shared_ptr<Problem>& problem) const
+    {
+        return std::any_of(entries.begin(), entries.end(),
+                           [&problem](const Entry& entry) { return entry.problem.get() == problem.get(); });
+    }
+
+    /**
+     *  @brief Function that frees all cached objects.
+     */
+    void clear()
+    {
+        entries.clear();
+    }
+};
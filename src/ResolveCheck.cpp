@@ -0,0 +1,161 @@
+/**
+ *  \file ResolveCheck.cpp
+ *
+ *  ResolveCheck Execution File
+ *
+ *  Check of the re-solve with new boundary values of the Poisson Solver Library. A problem
+ *  is solved with the first boundary values, then run(int) applies the second ones to the
+ *  assembled system by lifting the right hand side. The solution has to agree with the one
+ *  of a new problem that is assembled with the second boundary values from the start. The
+ *  constant value is changed, and the constant values are replaced by the ones given by
+ *  BoundaryValues. The shells are curved and locally refined at the inner boundary, so the
+ *  hanging node constraints are covered. Every problem is solved with CG, with CG and the
+ *  multigrid preconditioner, with the mixed precision solver and, if deal.II has UMFPACK,
+ *  with the direct solver.
+ *
+ *  Usage: ResolveCheck
+ */
+
+// Include from the Poisson Solver Library
+#include "../lib/poisson.hpp"
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ *  @brief Structure for the boundary values of one run.
+ */
+struct BoundaryCondition
+{
+    int value = 0;                          //!< Value of the constant boundary condition
+    bool constant = true;                   //!< True for the constant value, false for BoundaryValues
+};
+
+/**
+ *  @brief Structure for one linear solver the re-solve is checked with.
+ */
+struct SolverVariant
+{
+    std::string name;                       //!< Name of the solver in the output
+    SolverOptions options;                  //!< Solver options of the problems
+};
+
+/**
+ *  @brief Function that returns the linear solvers of the check.
+ *
+ *  @return Solvers with the output switched off.
+ */
+std::vector<SolverVariant> solverVariants()
+{
+    std::vector<SolverVariant> variants(3);
+    variants[0].name = "CG";
+    variants[1].name = "CG with multigrid";
+    variants[1].options.preconditioner = PreconditionerType::multigrid;
+    variants[2].name = "mixed precision";
+    variants[2].options.preconditioner = PreconditionerType::ssor;
+    variants[2].options.mixed_precision = true;
+#ifdef DEAL_II_WITH_UMFPACK
+    variants.push_back({"direct"});
+    variants.back().options.linear_solver = LinearSolverType::direct;
+#endif
+    for (SolverVariant& variant : variants)
+        variant.options.write_output = false;
+    return variants;
+}
+
+/**
+ *  @brief Function that compares the vertex values of two solutions on the same grid.
+ *
+ *  @param solution Solution to check.
+ *  @param reference Reference solution.
+ *  @return Euclidian norm of the difference relative to the norm of the reference.
+ */
+double relativeDifference(const SolutionMesh& solution, const SolutionMesh& reference)
+{
+    if (solution.values.size() != reference.values.size())
+        return std::numeric_limits<double>::infinity();
+
+    double difference = 0., norm = 0.;
+    for (std::size_t i = 0; i < reference.values.size(); ++i)
+    {
+        difference += (solution.values[i] - reference.values[i]) * (solution.values[i] - reference.values[i]);
+        norm += reference.values[i] * reference.values[i];
+    }
+    return std::sqrt(difference / norm);
+}
+
+/**
+ *  @brief Function that checks the re-solve of one problem with all linear solvers.
+ *
+ *  @param problemName Name of the problem in the output.
+ *  @param createProblem Creates a new problem for the given boundary condition and solver options.
+ *  @param first Boundary condition of the first run.
+ *  @param second Boundary condition of the re-solve.
+ *  @return True if the re-solve agrees with the new problem for all solvers.
+ */
+template <class ProblemFactory>
+bool checkResolve(const std::string& problemName, const ProblemFactory& createProblem,
+                  const BoundaryCondition& first, const BoundaryCondition& second)
+{
+    const double tolerance = 1e-7;
+    bool passed = true;
+    for (const SolverVariant& variant : solverVariants())
+    {
+        const auto resolved = createProblem(first, variant.options);
+        resolved->run();
+        resolved->set_homogeneous(second.constant);
+        resolved->run(second.value);
+
+        const auto reference = createProblem(second, variant.options);
+        reference->run();
+
+        const double error = relativeDifference(*resolved->solution_mesh(), *reference->solution_mesh());
+        const bool agrees = error <= tolerance;
+        passed = passed && agrees;
+
+        std::cout << std::left << std::setw(36) << problemName << std::setw(20) << variant.name << " difference "
+                  << std::scientific << std::setprecision(2) << error << (agrees ? "  ok" : "  FAILED") << std::endl;
+    }
+    return passed;
+}
+
+/**
+ *  @brief Main function that executes the check.
+ *
+ *  @return int 0 if all re-solves agree with the new problems, 1 otherwise.
+ */
+int main()
+{
+    const auto rectangle2D = [](const BoundaryCondition& condition, const SolverOptions& options)
+    {
+        return std::make_unique<Poisson<2>>(std::vector<int>{2, 1}, 3, 2, condition.value, condition.constant, options);
+    };
+    const auto shell2D = [](const BoundaryCondition& condition, const SolverOptions& options)
+    {
+        return std::make_unique<PoissonProblem<2, HyperShell<2>>>(HyperShell<2>({0.5, 1.0}), 1, 2, condition.value,
+                                                                  condition.constant, options);
+    };
+    const auto shell3D = [](const BoundaryCondition& condition, const SolverOptions& options)
+    {
+        return std::make_unique<PoissonProblem<3, HyperShell<3>>>(HyperShell<3>({0.5, 1.0}), 0, 1, condition.value,
+                                                                  condition.constant, options);
+    };
+
+    const BoundaryCondition constantOne{1, true}, constantThree{3, true}, distance{0, false};
+    bool passed = true;
+    passed = checkResolve("2D rectangle, constant 1 to 3", rectangle2D, constantOne, constantThree) && passed;
+    passed = checkResolve("2D rectangle, constant to distance", rectangle2D, constantOne, distance) && passed;
+    passed = checkResolve("2D shell, constant 1 to 3", shell2D, constantOne, constantThree) && passed;
+    passed = checkResolve("2D shell, constant to distance", shell2D, constantOne, distance) && passed;
+    passed = checkResolve("3D shell, constant 1 to 3", shell3D, constantOne, constantThree) && passed;
+    passed = checkResolve("3D shell, distance to constant", shell3D, distance, constantThree) && passed;
+
+    std::cout << (passed ? "All re-solves agree with newly assembled problems." : "Some re-solves differ from newly assembled problems.")
+              << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+/**
+ *  \file SolverThread.hpp
+ *
+ *  SolverThread Class Header File
+ */
+
+#pragma once
+
+// Include from the Poisson Solver Library
+#include "../lib/poisson.hpp"
+
+// Includes from the QT Library
+#include <QThread>
+#include <QString>
+#include <QElapsedTimer>
+
+#include <atomic>
+#include <functional>
+
+/**
+ *  @brief Class for the worker thread that executes the Poisson solver.
+ *  
+ *  The solver runs outside of the Qt event loop, so the GUI stays responsive during
+ *  the generation of the grid, the assembly and the solution of the Poisson problem.
+ *  The progress of the solver is forwarded to the GUI with Qt signals.
+ */
+class SolverThread : public QThread 
+{
+    Q_OBJECT
+
+public:
+    /**
+     *  @brief Solver call that is executed on the worker thread.
+     *
+     *  The call returns the function that takes over its result, e.g. stores the solved
+     *  Poisson object in the window. This function is executed on the GUI thread.
+     */
+    using Job = std::function<std::function<void()>()>;
+
+private:
+    /**
+     *  @brief Outcome of the last solver call.
+     */
+    enum class Outcome { finished, cancelled, failed };
+
+    Job job;                                    //!< Solver call that is executed on the worker thread
+    std::function<void()> takeOverResult;       //!< Result of the solver call, is executed on the GUI thread
+    Outcome outcome = Outcome::finished;        //!< Outcome of the last solver call
+    QString failureMessage;                     //!< Message of the exception thrown by the last solver call
+    std::atomic<bool> cancelRequested{false};   //!< Is set by the GUI thread to cancel the solver
+    QElapsedTimer iterationTimer;               //!< Limits the rate of the CG iteration signals
+
+public:
+    /**
+     *  @brief Constructor for the SolverThread class.
+     * 
+     *  @param parent Pointer object for the initialization of the base class.
+     *  @return New SolverThread class object.
+     * 
+     *  The outcome of a solver call is reported when the thread has returned, so a new
+     *  job can be started from the slots of the reported signals.
+     */
+    SolverThread(QObject* parent = nullptr) : QThread(parent) 
+    {
+        QObject::connect(this, &QThread::finished, this, &SolverThread::reportOutcome);
+    }
+
+    /**
+     *  @brief Function that executes the given solver call on the worker thread.
+     * 
+     *  @param newJob Solver call, e.g. the construction and the run of a Poisson object.
+     * 
+     *  The finished() signal is emitted shortly before the thread has returned, so the
+     *  thread is joined first. Otherwise start() would ignore the new job.
+     */
+    void startJob(Job newJob)
+    {
+        wait();
+        job = std::move(newJob);
+        cancelRequested = false;
+        iterationTimer.start();
+        start();
+    }
+
+    /**
+     *  @brief Function that requests the cancellation of the running solver.
+     * 
+     *  The solver checks the request at the beginning of every phase and after every
+     *  CG iteration and stops with an ExcSolveCancelled exception.
+     */
+    void cancel()
+    {
+        cancelRequested = true;
+    }
+
+    /**
+     *  @brief Function that returns the progress callback for the solver options.
+     * 
+     *  @return Callback that emits the progressChanged() signal and reports cancellation requests.
+     * 
+     *  The beginning of every phase is forwarded to the GUI. The CG iterations are only
+     *  forwarded every 100 ms, so the event loop is not flooded by fast iterations.
+     */
+    ProgressCallback progressCallback()
+    {
+        return [this](SolvePhase phase, unsigned int step)
+        {
+            if (phase != SolvePhase::solve || step == 0 || iterationTimer.elapsed() > 100)
+            {
+                iterationTimer.restart();
+                emit progressChanged(static_cast<int>(phase), static_cast<int>(step));
+            }
+            return !cancelRequested;
+        };
+    }
+
+signals:
+    void progressChanged(int phase, int step);  //!< Emitted for every phase and for the CG iterations
+    void solveFinished();                       //!< Emitted if the solver call has finished and its result was taken over
+    void solveCancelled();                      //!< Emitted if the solver call was cancelled
+    void solveFailed(const QString& message);   //!< Emitted if the solver call has thrown an exception
+
+protected:
+    /**
+     *  @brief Function that is executed on the worker thread.
+     * 
+     *  The solver call is executed and its outcome is stored. The GUI is not accessed
+     *  from the worker thread, the outcome is reported by reportOutcome().
+     */
+    void run() override
+    {
+        try
+        {
+            takeOverResult = job();
+            outcome = Outcome::finished;
+        }
+        catch (const ExcSolveCancelled&)
+        {
+            outcome = Outcome::cancelled;
+        }
+        catch (const std::exception& exception)
+        {
+            failureMessage = QString::fromStdString(exception.what());
+            outcome = Outcome::failed;
+        }
+    }
+
+private:
+    /**
+     *  @brief Function that reports the outcome of the solver call on the GUI thread.
+     * 
+     *  The result of a finished solver call is taken over before the solveFinished() signal
+     *  is emitted. Afterwards the solver call and its result are released, so they do not
+     *  keep the Poisson objects alive until the next job.
+     */
+    void reportOutcome()
+    {
+        std::function<void()> result = std::move(takeOverResult);
+        takeOverResult = nullptr;
+        job = nullptr;
+
+        switch (outcome)
+        {
+            case Outcome::finished:
+                if (result) { result(); }
+                emit solveFinished();
+                break;
+            case Outcome::cancelled:
+                emit solveCancelled();
+                break;
+            case Outcome::failed:
+                emit solveFailed(failureMessage);
+                break;
+        }
+    }
+};
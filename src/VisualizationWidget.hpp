@@ -18,14 +18,44 @@
 #include <vtkDataSet.h>
 #include <vtkDataSetMapper.h>
 #include <vtkDataSetReader.h>
-#include <vtkActor.h>
+#include <vtkDataSetSurfaceFilter.h>
+#include <vtkTriangleFilter.h>
+#include <vtkQuadricDecimation.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkMapperCollection.h>
+#include <vtkLODActor.h>
+#include <vtkRenderWindowInteractor.h>
 #include <vtkTextActor.h>
 #include <vtkTextProperty.h>
 #include <vtkCubeAxesActor.h>
 #include <vtkLookupTable.h>
 #include <vtkScalarBarActor.h>
 #include <vtkNamedColors.h>
-#include <vtkBoxClipDataSet.h>
+#include <vtkPlane.h>
+#include <vtkTableBasedClipDataSet.h>
+#include <vtkCutter.h>
+#include <vtkImplicitPlaneWidget2.h>
+#include <vtkImplicitPlaneRepresentation.h>
+#include <vtkCommand.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkPoints.h>
+#include <vtkPointData.h>
+#include <vtkCellArray.h>
+#include <vtkCellType.h>
+#include <vtkDoubleArray.h>
+#include <vtkTypeInt64Array.h>
+
+#include <algorithm>
+
+/**
+ *  @brief Enumeration of the views of a three dimensional data set.
+ */
+enum class ViewMode
+{
+    clip,                                        //!< Volume behind the draggable clip plane
+    slice,                                       //!< Intersection of the volume with the draggable plane
+    full                                         //!< Surface of the whole volume
+};
 
 /**
  *  @brief Class for the visualization of the solution of the Poisson problem.
@@ -40,27 +70,50 @@ private:
     vtkNew<vtkGenericOpenGLRenderWindow> window; //!< Shows the finished visualization
     vtkNew<vtkRenderer> renderer;                //!< Renders the given actors
     vtkNew<vtkCamera> camera;                    //!< Defines the view point 
-    vtkNew<vtkBoxClipDataSet> boxClip;           //!< Shows the inside of the 3D square grid
-    vtkNew<vtkDataSetMapper> mapper;             //!< Connects the data set with the actor
-    vtkNew<vtkActor> actor;                      //!< Contains the visualization data set
+    vtkNew<vtkPlane> clipPlane;                  //!< Plane that clips or slices the 3D data set
+    vtkNew<vtkTableBasedClipDataSet> clip;       //!< Shows the inside of the 3D data set behind the clip plane
+    vtkNew<vtkCutter> slice;                     //!< Intersection of the 3D data set with the clip plane
+    vtkNew<vtkPolyDataMapper> sliceMapper;       //!< Connects the slice with the slice actor
+    vtkNew<vtkActor> sliceActor;                 //!< Contains the slice
+    vtkNew<vtkImplicitPlaneRepresentation> planeRepresentation; //!< Draws the clip plane with its normal
+    vtkNew<vtkImplicitPlaneWidget2> planeWidget; //!< Moves and rotates the clip plane with the mouse
+    vtkNew<vtkDataSetSurfaceFilter> surfaceFilter; //!< Extracts the visible surface of the data set once
+    vtkNew<vtkDataSetMapper> mapper;             //!< Connects the full resolution surface with the actor
+    vtkNew<vtkTriangleFilter> triangleFilter;    //!< Splits the surface into triangles for the decimation
+    vtkNew<vtkQuadricDecimation> decimation;     //!< Coarse surface that is rendered during interaction
+    vtkNew<vtkPolyDataMapper> decimatedMapper;   //!< Connects the coarse surface with the actor
+    vtkNew<vtkLODActor> actor;                   //!< Contains the visualization data set in several levels of detail
     vtkNew<vtkTextActor> textActor;              //!< Contains the description string
     vtkNew<vtkCubeAxesActor> cubeAxesActor;      //!< Contains the cartesian axes
     vtkNew<vtkLookupTable> lut;                  //!< Contains the scalar value range
     vtkNew<vtkScalarBarActor> scalarBar;         //!< Contains the color bar on the right
     vtkNew<vtkNamedColors> colors;               //!< Defines the used colors
 
+    std::shared_ptr<SolutionMesh> solutionMesh;  //!< Owns the arrays of the shown solution
+    vtkSmartPointer<vtkDataSet> shownDataSet;    //!< Data set that is currently visualized
+    bool threeDimensional = false;               //!< True if the shown data set is three dimensional
+    bool decimatedLevelOfDetail = false;         //!< True if the actor renders the decimated surface during interaction
+    ViewMode viewMode = ViewMode::clip;          //!< View of three dimensional data sets
+
+    static constexpr vtkIdType decimationCells = 100000; //!< Number of cells above which a decimated surface is used during interaction
+    static constexpr double decimationReduction = 0.9;   //!< Fraction of the surface triangles removed by the decimation
+    static constexpr double interactiveFrameRate = 60.;  //!< Frame rate the level of detail is chosen for during interaction
+
 public:
     /**
      *  @brief Function that sets up the vtkGenericOpenGLRenderWindow object.
      * 
      *  The render window is set up and the background is set to black. 
-     *  The renderer object is then added to the window.
+     *  The renderer object is then added to the window. During interaction the
+     *  level of detail actor picks the finest representation that still renders
+     *  at the interactive frame rate, at rest the full resolution is rendered.
      */
     void setupWindow()
     {
         setRenderWindow(window.Get());
         renderer->SetBackground(colors->GetColor3d("Black").GetData());
         renderWindow()->AddRenderer(renderer);
+        renderWindow()->GetInteractor()->SetDesiredUpdateRate(interactiveFrameRate);
     }
 
     /**
@@ -77,6 +130,57 @@ public:
         renderer->SetActiveCamera(camera);
     }
 
+    /**
+     *  @brief Function that sets up the vtkImplicitPlaneWidget2 object.
+     * 
+     *  The plane widget is connected to the interactor of the render window. Every
+     *  interaction copies the dragged plane into the clip plane, so only the clip and
+     *  slice filters are executed again on the existing data set. The decimated level of
+     *  detail is taken from the actor while the plane is dragged, see startedPlaneDrag().
+     */
+    void setupPlaneWidget()
+    {
+        planeRepresentation->SetPlaceFactor(1.0);
+        planeRepresentation->OutlineTranslationOff();
+        planeWidget->SetInteractor(renderWindow()->GetInteractor());
+        planeWidget->SetCurrentRenderer(renderer);
+        planeWidget->SetRepresentation(planeRepresentation);
+        planeWidget->AddObserver(vtkCommand::StartInteractionEvent, this, &VisualizationWidget::startedPlaneDrag);
+        planeWidget->AddObserver(vtkCommand::InteractionEvent, this, &VisualizationWidget::movedPlane);
+        planeWidget->AddObserver(vtkCommand::EndInteractionEvent, this, &VisualizationWidget::endedPlaneDrag);
+    }
+
+    /**
+     *  @brief Function that is called by the plane widget when the plane is grabbed.
+     * 
+     *  The decimated surface is computed from the clipped surface. Every move of the plane
+     *  changes the clip, so the decimation of the full resolution surface would run again
+     *  for every frame of the drag. It is removed from the actor until the plane is released.
+     */
+    void startedPlaneDrag(vtkObject*, unsigned long, void*)
+    {
+        if (decimatedLevelOfDetail) { actor->GetLODMappers()->RemoveItem(decimatedMapper); }
+    }
+
+    /**
+     *  @brief Function that is called by the plane widget while the plane is dragged.
+     */
+    void movedPlane(vtkObject*, unsigned long, void*)
+    {
+        planeRepresentation->GetPlane(clipPlane);
+    }
+
+    /**
+     *  @brief Function that is called by the plane widget when the plane is released.
+     * 
+     *  The decimated surface is used again, it is computed once for the new position of
+     *  the plane with the next interaction.
+     */
+    void endedPlaneDrag(vtkObject*, unsigned long, void*)
+    {
+        if (decimatedLevelOfDetail) { actor->AddLODMapper(decimatedMapper); }
+    }
+
     /**
      *  @brief Constructor for the VisualizationWidget class.
      * 
@@ -87,6 +191,7 @@ public:
     {
         setupWindow();
         setupCamera();
+        setupPlaneWidget();
     }
 
     /**
@@ -102,53 +207,141 @@ public:
     }
 
     /**
-     *  @brief Function that sets up the vtkBoxClipDataSet object. 
+     *  @brief Function that places the clip plane in a new 3D data set. 
      * 
      *  @param dataSet Data set which should be visualized.
      * 
-     *  The center and the corner point and the corresponding normal vectors are defined.
-     *  With this geometric variables one quarter of the 3D square grid can be clipped,
-     *  which allows to inspect the inside of the three dimensional data set.
+     *  The plane widget is fitted to the bounds of the data set and the plane is put
+     *  through its center, so the clip shows the inside of the three dimensional data
+     *  set. The clip and slice filters evaluate the same plane.
      */
-    void setupBoxClip(vtkSmartPointer<vtkDataSet> dataSet)
+    void setupClipPlane(vtkSmartPointer<vtkDataSet> dataSet)
     {
-        double* bounds = dataSet->GetBounds();
-        double* center = dataSet->GetCenter();
-        double minBoxPoint[3] = { center[0], center[1], center[2] };
-        double maxBoxPoint[3] = { bounds[1], bounds[3], bounds[5] };
+        planeRepresentation->PlaceWidget(dataSet->GetBounds());
+        planeRepresentation->SetOrigin(dataSet->GetCenter());
+        planeRepresentation->SetNormal(1.0, 0.0, 0.0);
+        planeRepresentation->GetPlane(clipPlane);
 
-        const double minusx[] = {-1.0, 0.0, 0.0}; const double plusx[] = {1.0, 0.0, 0.0};
-        const double minusy[] = {0.0, -1.0, 0.0}; const double plusy[] = {0.0, 1.0, 0.0};
-        const double minusz[] = {0.0, 0.0, -1.0}; const double plusz[] = {0.0, 0.0, 1.0};
+        clip->SetClipFunction(clipPlane);
+        slice->SetCutFunction(clipPlane);
+        sliceMapper->SetInputConnection(slice->GetOutputPort());
+        sliceMapper->SetLookupTable(lut);
+        sliceActor->SetMapper(sliceMapper);
+    }
 
-        boxClip->SetInputData(dataSet);
-        boxClip->GenerateClippedOutputOn();
-        boxClip->SetBoxClip(minusx, minBoxPoint, minusy, minBoxPoint, minusz, minBoxPoint, 
-                            plusx, maxBoxPoint, plusy, maxBoxPoint, plusz, maxBoxPoint);
+    /**
+     *  @brief Function that connects the shown data set to the filters of the view mode.
+     * 
+     *  The volume is clipped in the clip view and hidden in the slice view. The plane
+     *  widget is shown for both, the full view and two dimensional data sets show the
+     *  whole surface without the plane widget.
+     */
+    void applyViewMode()
+    {
+        const bool planeView = threeDimensional && viewMode != ViewMode::full;
+        if (planeView) { surfaceFilter->SetInputConnection(clip->GetOutputPort()); }
+        else           { surfaceFilter->SetInputData(shownDataSet); }
 
-        mapper->SetInputConnection(boxClip->GetOutputPort(1));
+        actor->SetVisibility(!planeView || viewMode == ViewMode::clip);
+        sliceActor->SetVisibility(planeView && viewMode == ViewMode::slice);
+        planeWidget->Off();
+        if (planeView) { planeWidget->On(); }
     }
 
     /**
-     *  @brief Function that sets up the vtkActor object. 
+     *  @brief Function that hands a data set to the existing pipeline.
      * 
      *  @param dataSet Data set which should be visualized.
      * 
-     *  If the given data set is three dimensional, a box clip is generated. If it is two
-     *  dimensional, the whole data set is given as input data. The look up table for the
-     *  color mapping is set up. The actor object is then added to the renderer.
+     *  Only the inputs of the first filters and the scalar ranges of the mappers are
+     *  changed, the filters execute again on the next render.
+     */
+    void connectDataSet(vtkSmartPointer<vtkDataSet> dataSet)
+    {
+        shownDataSet = dataSet;
+        if (threeDimensional)
+        {
+            clip->SetInputData(dataSet);
+            slice->SetInputData(dataSet);
+        }
+        applyViewMode();
+
+        mapper->SetScalarRange(dataSet->GetScalarRange());
+        decimatedMapper->SetScalarRange(dataSet->GetScalarRange());
+        sliceMapper->SetScalarRange(dataSet->GetScalarRange());
+    }
+
+    /**
+     *  @brief Function that checks if a data set has the same mesh as the shown one.
+     * 
+     *  @param dataSet Data set which should be visualized.
+     *  @return True if the number of points and cells and the bounds are equal.
+     */
+    bool hasShownMesh(vtkSmartPointer<vtkDataSet> dataSet)
+    {
+        if (!shownDataSet) { return false; }
+        if (shownDataSet->GetNumberOfPoints() != dataSet->GetNumberOfPoints() ||
+            shownDataSet->GetNumberOfCells() != dataSet->GetNumberOfCells()) { return false; }
+
+        const double* shownBounds = shownDataSet->GetBounds();
+        const double* bounds = dataSet->GetBounds();
+        return std::equal(bounds, bounds + 6, shownBounds);
+    }
+
+    /**
+     *  @brief Function that sets up the decimated level of detail of the vtkLODActor object.
+     * 
+     *  @param dataSet Data set which should be visualized.
+     * 
+     *  Only the visible surface is rendered, so the decimation works on the extracted
+     *  surface and not on the volume cells. The quadric decimation keeps the scalar
+     *  values in its error metric, so the coarse surface shows the same colors. Small
+     *  data sets render fast enough at full resolution and only keep the point cloud
+     *  level of detail that vtkLODActor builds on its own.
+     */
+    void setupLevelOfDetail(vtkSmartPointer<vtkDataSet> dataSet)
+    {
+        actor->GetLODMappers()->RemoveAllItems();
+        decimatedLevelOfDetail = dataSet->GetNumberOfCells() >= decimationCells;
+        if (!decimatedLevelOfDetail) { return; }
+
+        triangleFilter->SetInputConnection(surfaceFilter->GetOutputPort());
+        decimation->SetInputConnection(triangleFilter->GetOutputPort());
+        decimation->SetTargetReduction(decimationReduction);
+        decimation->AttributeErrorMetricOn();
+        decimation->ScalarsAttributeOn();
+
+        decimatedMapper->SetInputConnection(decimation->GetOutputPort());
+        decimatedMapper->SetScalarRange(dataSet->GetScalarRange());
+        decimatedMapper->SetLookupTable(lut);
+        actor->AddLODMapper(decimatedMapper);
+    }
+
+    /**
+     *  @brief Function that sets up the vtkLODActor object. 
+     * 
+     *  @param dataSet Data set which should be visualized.
+     * 
+     *  If the given data set is three dimensional, the clip plane is placed in it. If it
+     *  is two dimensional, the whole data set is given as input data. The surface of the
+     *  result is extracted once and shared by the full resolution and the decimated level
+     *  of detail. The look up table for the color mapping is set up. The actor and the
+     *  slice actor are then added to the renderer.
      */
     void setupActor(vtkSmartPointer<vtkDataSet> dataSet)
     {
         int zmax = dataSet->GetBounds()[5];
-        if (dataSetIsTreeDimensional(zmax)) { setupBoxClip(dataSet); }
-        else                                { mapper->SetInputData(dataSet); }
+        threeDimensional = dataSetIsTreeDimensional(zmax);
+        if (threeDimensional) { setupClipPlane(dataSet); }
 
-        mapper->SetScalarRange(dataSet->GetScalarRange());
+        mapper->SetInputConnection(surfaceFilter->GetOutputPort());
         mapper->SetLookupTable(lut);
-
         actor->SetMapper(mapper);
+        setupLevelOfDetail(dataSet);
+        connectDataSet(dataSet);
+
         renderer->AddActor(actor);
+        renderer->AddActor(sliceActor);
     }
 
     /**
@@ -221,14 +414,26 @@ public:
      *  @param description Information if the used grid is newly generated.
      *  @param physicalQuantity The name of the phyical quantity that is calculated by the Poisson Solver.
      * 
-     *  First all remaining actors are removed from the render window. Then the data set,
-     *  the cube axes, the text description and the color bar are initialized. At the end
-     *  the camera is set to the bounds of the new data set and all new input is rendered.
+     *  A data set on the shown mesh, e.g. a new solution for other boundary values, is
+     *  only handed to the existing pipeline, so the camera, the clip plane and the actors
+     *  stay as they are. Otherwise first all remaining actors are removed from the render
+     *  window. Then the data set, the cube axes, the text description and the color bar
+     *  are initialized. At the end the camera is set to the bounds of the new data set
+     *  and all new input is rendered.
      */
     void visualizeDataSet(vtkSmartPointer<vtkDataSet> dataSet,
                           const char* description, 
                           const char* physicalQuantity)
     {
+        if (hasShownMesh(dataSet))
+        {
+            connectDataSet(dataSet);
+            textActor->SetInput(description);
+            scalarBar->SetTitle(physicalQuantity);
+            renderWindow()->Render();
+            return;
+        }
+
         renderer->RemoveAllViewProps();
 
         setupActor(dataSet);
@@ -258,4 +463,61 @@ public:
         vtkSmartPointer<vtkDataSet> dataSet = reader->GetOutput();
         visualizeDataSet(dataSet, description, "Physical Quantity"); 
     }
+
+    /**
+     *  @brief Function visualizes a solution that is passed from the Poisson solver in memory.
+     * 
+     *  @param mesh Vertices, cells and vertex values of the solution.
+     *  @param description Information if the used grid is newly generated.
+     * 
+     *  The arrays of the solution mesh are wrapped by VTK data arrays without copying
+     *  them, so neither a file has to be written and parsed nor the data has to be
+     *  duplicated. The widget keeps the solution mesh alive while it is shown.
+     */
+    void showSolution(std::shared_ptr<SolutionMesh> mesh, const char* description)
+    {
+        vtkNew<vtkDoubleArray> coordinates;
+        coordinates->SetNumberOfComponents(3);
+        coordinates->SetArray(mesh->points.data(), mesh->points.size(), 1);
+        vtkNew<vtkPoints> points;
+        points->SetData(coordinates);
+
+        vtkNew<vtkTypeInt64Array> offsets;
+        offsets->SetArray(mesh->offsets.data(), mesh->offsets.size(), 1);
+        vtkNew<vtkTypeInt64Array> connectivity;
+        connectivity->SetArray(mesh->connectivity.data(), mesh->connectivity.size(), 1);
+        vtkNew<vtkCellArray> cells;
+        cells->SetData(offsets, connectivity);
+
+        vtkNew<vtkDoubleArray> values;
+        values->SetName("solution");
+        values->SetArray(mesh->values.data(), mesh->values.size(), 1);
+
+        vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+        grid->SetPoints(points);
+        grid->SetCells(mesh->dim == 3 ? VTK_HEXAHEDRON : VTK_QUAD, cells);
+        grid->GetPointData()->SetScalars(values);
+
+        // The shown data set still wraps the arrays of the previous mesh, which may only be
+        // freed after the pipeline has been connected to the new grid and rendered
+        visualizeDataSet(grid, description, "Physical Quantity");
+        solutionMesh = mesh;
+    }
+
+public slots:
+    /**
+     *  @brief Function that switches the view of three dimensional data sets.
+     * 
+     *  @param mode Index of the view mode, see ViewMode.
+     * 
+     *  Only the connection of the existing filters changes, the data set is kept.
+     */
+    void switchedViewMode(int mode)
+    {
+        viewMode = static_cast<ViewMode>(mode);
+        if (!shownDataSet) { return; }
+
+        applyViewMode();
+        renderWindow()->Render();
+    }
 };
@@ -16,6 +16,13 @@
 #include <QLineEdit>
 #include <QIntValidator>
 #include <QPushButton>
+#include <QStatusBar>
+
+// Include for the SolverThread Class
+#include "SolverThread.hpp"
+
+// Include for the ProblemCache Class
+#include "ProblemCache.hpp"
 
 /**
  *  @brief Class for the GUI window that contains the visualization widget.
@@ -52,22 +59,31 @@ private:
     QFormLayout* FEMFormLayout;               //!< Organizes the FEM parameters in rows
     QComboBox* refinement;                    //!< Selects the refinement level on the mesh
     QComboBox* shapeFunction;                 //!< Selects the shape function order on the mesh
+    QComboBox* preconditioner;                //!< Selects the preconditioner of the CG solver
+    QComboBox* viewMode;                      //!< Selects the view of 3D solutions
 
     QPushButton* runButton;                   //!< Executes the Poisson Solver 
+    QPushButton* cancelButton;                //!< Cancels the running Poisson Solver
+    SolverThread* solverThread;               //!< Executes the Poisson Solver outside of the event loop
 
 private:
     std::vector<int> _dimensions2D = std::vector<int>(2, 0);          //!< Saves the 2D square dimensions
-    Poisson<2>* poissonProblem2D;                                     //!< Points to the 2D square Poisson object
+    std::shared_ptr<Poisson<2>> poissonProblem2D;                     //!< Points to the 2D square Poisson object
     std::vector<int> _dimensions3D = std::vector<int>(3, 0);          //!< Saves the 3D square dimensions
-    Poisson<3>* poissonProblem3D;                                     //!< Points to the 3D square Poisson object
+    std::shared_ptr<Poisson<3>> poissonProblem3D;                     //!< Points to the 3D square Poisson object
     std::vector<double> _dimensionsRad = std::vector<double>(2, 0.0); //!< Saves the radial dimensions
-    Radial_Poisson* poissonProblemRad;                                //!< Points to the radial Poisson object
+    std::shared_ptr<Radial_Poisson> poissonProblemRad;                //!< Points to the radial Poisson object
+    ProblemCache problemCache{std::size_t(2) << 30};                  //!< Keeps recently solved Poisson objects up to 2 GB, the pointers above are released on eviction
 
     int _refinement = 0;             //!< Saves the refinement level on the mesh
     int _shapeFunction = 0;          //!< Saves the shape funtion order on the mesh
     int _boundaryValue = 0;          //!< Saves the value on the boundary on the mesh
     QString _boundaryCondition;      //!< Saves the boundary condition type on the mesh
+    QString _preconditioner;         //!< Saves the preconditioner of the CG solver
     bool boundaryIsConstant = false; //!< Saves if the boundary condition is constant
+    std::shared_ptr<SolutionMesh> resultMesh; //!< Saves the solution passed from the running solver
+    SolveStatistics resultStatistics;   //!< Saves the statistics passed from the running solver
+    const char* resultDescription = ""; //!< Saves the description of the running solver
 
 public:
     /**
@@ -97,7 +113,7 @@ public:
     {
         visualizationWidget = new VisualizationWidget();
         visualizationWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-        gridLayout->addWidget(visualizationWidget, 0, 0, 4, 1);
+        gridLayout->addWidget(visualizationWidget, 0, 0, 5, 1);
     }
 
     /**
@@ -168,8 +184,11 @@ public:
      * 
      *  The form layout is filled with the refinement combo box which selects the level
      *  of refinement on the mesh and the shape function combo box which selects the order
-     *  of the shape funtions on the mesh. This form layout is then added to the 
-     *  FEMGroupBox, which is then added to the grid layout of the window.
+     *  of the shape funtions on the mesh. The preconditioner combo box selects the
+     *  preconditioner of the CG solver. The view mode combo box switches between the
+     *  clip plane, the slice and the full volume of 3D solutions without solving again.
+     *  This form layout is then added to the FEMGroupBox, which is then added to the
+     *  grid layout of the window.
      */
     void setupFEMGroupBox()
     {
@@ -187,6 +206,21 @@ public:
         shapeFunction->addItem("3");
         FEMFormLayout->addRow(new QLabel(tr("Shape Function Order = ")), shapeFunction);
 
+        preconditioner = new QComboBox();
+        preconditioner->addItem("Multigrid");
+        preconditioner->addItem("SSOR");
+        preconditioner->addItem("Chebyshev");
+        preconditioner->addItem("None");
+        FEMFormLayout->addRow(new QLabel(tr("Preconditioner = ")), preconditioner);
+
+        viewMode = new QComboBox();
+        viewMode->addItem("Clip Plane");
+        viewMode->addItem("Slice");
+        viewMode->addItem("Full Volume");
+        FEMFormLayout->addRow(new QLabel(tr("3D View = ")), viewMode);
+        QObject::connect(viewMode, SIGNAL(currentIndexChanged(int)),
+                         visualizationWidget, SLOT(switchedViewMode(int)));
+
         FEMGroupBox = new QGroupBox(tr("FEM PARAMETERS"));
         FEMGroupBox->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Minimum);
         FEMGroupBox->setLayout(FEMFormLayout);
@@ -198,6 +232,8 @@ public:
      * 
      *  After the initialization of the push button the button is connected to the 
      *  clickedRunButton() function, which executes the solution of the Poisson equation.
+     *  The cancel button is connected to the clickedCancelButton() function and is only
+     *  enabled while the Poisson solver is running.
      */
     void setupRunButton()
     {
@@ -206,6 +242,28 @@ public:
         runButton->setText("Solve Poisson Problem");
         QObject::connect(runButton, SIGNAL(clicked()), this, SLOT(clickedRunButton()));
         gridLayout->addWidget(runButton, 3, 1);
+
+        cancelButton = new QPushButton(this);
+        cancelButton->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
+        cancelButton->setText("Cancel");
+        cancelButton->setEnabled(false);
+        QObject::connect(cancelButton, SIGNAL(clicked()), this, SLOT(clickedCancelButton()));
+        gridLayout->addWidget(cancelButton, 4, 1);
+    }
+
+    /**
+     *  @brief Function that sets up the solverThread object.
+     * 
+     *  The worker thread executes the Poisson solver. Its signals are connected to the
+     *  slots that show the progress in the status bar and visualize the solution.
+     */
+    void setupSolverThread()
+    {
+        solverThread = new SolverThread(this);
+        QObject::connect(solverThread, SIGNAL(progressChanged(int, int)), this, SLOT(updateProgress(int, int)));
+        QObject::connect(solverThread, SIGNAL(solveFinished()), this, SLOT(finishedSolve()));
+        QObject::connect(solverThread, SIGNAL(solveCancelled()), this, SLOT(cancelledSolve()));
+        QObject::connect(solverThread, SIGNAL(solveFailed(const QString&)), this, SLOT(failedSolve(const QString&)));
     }
 
     /**
@@ -222,6 +280,19 @@ public:
         setupBoundaryGroupBox();
         setupFEMGroupBox();
         setupRunButton();
+        setupSolverThread();
+    }
+
+    /**
+     *  @brief Destructor for the VisualizationWindow class.
+     * 
+     *  A running Poisson solver is cancelled and the worker thread is joined before
+     *  the window is destroyed.
+     */
+    ~VisualizationWindow()
+    {
+        solverThread->cancel();
+        solverThread->wait();
     }
 
     /**
@@ -295,11 +366,13 @@ public:
      */
     bool square2DGridNotChanged()
     {
-        return (_dimensions2D[0]   == dimension_A->text().toInt() &&
+        return (poissonProblem2D &&
+                _dimensions2D[0]   == dimension_A->text().toInt() &&
                 _dimensions2D[1]   == dimension_B->text().toInt() &&
                 _refinement        == refinement->currentText().toInt() &&
                 _shapeFunction     == shapeFunction->currentText().toInt() &&
-                _boundaryCondition == boundaryCondition->currentText());
+                _boundaryCondition == boundaryCondition->currentText() &&
+                _preconditioner    == preconditioner->currentText());
     }
 
     /**
@@ -307,12 +380,14 @@ public:
      */
     bool square3DGridNotChanged()
     {
-        return (_dimensions3D[0]   == dimension_A->text().toInt() &&
+        return (poissonProblem3D &&
+                _dimensions3D[0]   == dimension_A->text().toInt() &&
                 _dimensions3D[1]   == dimension_B->text().toInt() &&
                 _dimensions3D[2]   == dimension_C->text().toInt() &&
                 _refinement        == refinement->currentText().toInt() &&
                 _shapeFunction     == shapeFunction->currentText().toInt() &&
-                _boundaryCondition == boundaryCondition->currentText());
+                _boundaryCondition == boundaryCondition->currentText() &&
+                _preconditioner    == preconditioner->currentText());
     }
 
     /**
@@ -320,11 +395,92 @@ public:
      */
     bool radialGridNotChanged()
     {
-        return (_dimensionsRad[0]  == dimension_A->text().toInt() &&
-                _dimensionsRad[1]  == dimension_B->text().toInt() &&
+        return (poissonProblemRad &&
+                _dimensionsRad[0]  == dimension_A->text().toDouble() &&
+                _dimensionsRad[1]  == dimension_B->text().toDouble() &&
                 _refinement        == refinement->currentText().toInt() &&
                 _shapeFunction     == shapeFunction->currentText().toInt() &&
-                _boundaryCondition == boundaryCondition->currentText());
+                _boundaryCondition == boundaryCondition->currentText() &&
+                _preconditioner    == preconditioner->currentText());
+    }
+
+    /**
+     *  @brief Function that returns the solver options selected in the GUI.
+     * 
+     *  The linear solver is selected automatically: moderate 2D systems are factorized
+     *  once, so changing the boundary value only costs a forward and backward substitution.
+     *  The selected preconditioner is used for all other systems.
+     */
+    SolverOptions selectedSolverOptions()
+    {
+        SolverOptions options;
+        options.progress = solverThread->progressCallback();
+        options.write_output = false;
+        options.linear_solver = LinearSolverType::automatic;
+        if      (_preconditioner == "Multigrid") { options.preconditioner = PreconditionerType::multigrid; }
+        else if (_preconditioner == "SSOR")      { options.preconditioner = PreconditionerType::ssor; }
+        else if (_preconditioner == "Chebyshev") { options.preconditioner = PreconditionerType::chebyshev; }
+        else                                     { options.preconditioner = PreconditionerType::identity; }
+        return options;
+    }
+
+    /**
+     *  @brief Function that starts the Poisson solver on the worker thread.
+     * 
+     *  @param job Solver call that is executed on the worker thread. The function it returns
+     *             is executed on the GUI thread and stores the solution in resultMesh.
+     *  @param description Information if the used grid is newly generated.
+     * 
+     *  The run button is disabled until the solver has finished, so the Poisson objects
+     *  are not accessed by the GUI while the worker thread uses them. The solved Poisson
+     *  objects and the cache are only changed on the GUI thread by the returned function.
+     */
+    void startSolver(SolverThread::Job job, const char* description)
+    {
+        resultDescription = description;
+
+        runButton->setEnabled(false);
+        cancelButton->setEnabled(true);
+        solverThread->startJob(job);
+    }
+
+    /**
+     *  @brief Function that releases the Poisson objects that were evicted from the cache.
+     * 
+     *  The window keeps the last solved object of every mesh type for re-solves with new
+     *  boundary values. An evicted object would otherwise stay alive through these pointers
+     *  and the memory limit of the cache would not bound the memory of the window. The next
+     *  solve on a released grid generates a new grid.
+     */
+    void releaseEvictedProblems()
+    {
+        if (poissonProblem2D && !problemCache.contains(poissonProblem2D))   { poissonProblem2D.reset(); }
+        if (poissonProblem3D && !problemCache.contains(poissonProblem3D))   { poissonProblem3D.reset(); }
+        if (poissonProblemRad && !problemCache.contains(poissonProblemRad)) { poissonProblemRad.reset(); }
+    }
+
+    /**
+     *  @brief Function that stores the result of the solver for the finishedSolve() slot.
+     * 
+     *  @param statistics Statistics of the solver run.
+     *  @param mesh Solution on the grid of the solved Poisson object.
+     */
+    void takeOverResult(const SolveStatistics& statistics, std::shared_ptr<SolutionMesh> mesh)
+    {
+        resultStatistics = statistics;
+        resultMesh = std::move(mesh);
+    }
+
+    /**
+     *  @brief Function that resets the GUI after the solver has stopped.
+     * 
+     *  @param message Message that is shown in the status bar.
+     */
+    void stoppedSolver(const QString& message)
+    {
+        runButton->setEnabled(true);
+        cancelButton->setEnabled(false);
+        statusBar()->showMessage(message);
     }
 
     /**
@@ -355,9 +511,10 @@ public:
      *  The function checks if the mesh can be reused or if the program has to generate
      *  a new mesh. If only the boundary value has changed, the same mesh is used again for
      *  the new calculation. If this is not the case, all input parameters are read into the 
-     *  respective variables and a new instance of the Poisson class is initialized. This 
-     *  class is then used to solve the Poisson equation on the 2D square grid. The solution 
-     *  is visualized by the visualization widget.
+     *  respective variables. A Poisson object with the same grid is taken from the cache of
+     *  recently solved problems, otherwise a new instance of the Poisson class is initialized
+     *  and added to the cache. This class is then used to solve the Poisson equation on the 
+     *  2D square grid. The solution is visualized by the visualization widget.
      */
     void solve2DsquareGrid()
     {
@@ -366,8 +523,15 @@ public:
             if (boundaryValueNotChanged()) { return; }
             _boundaryValue = boundaryValue->text().toInt();
 
-            poissonProblem2D->run(_boundaryValue);
-            visualizationWidget->openFile("solution-2d.vtk", "Same Grid reused.");
+            int boundaryValue = _boundaryValue;
+            std::shared_ptr<Poisson<2>> problem = poissonProblem2D;
+            startSolver([this, problem, boundaryValue] 
+                        { 
+                            SolveStatistics statistics = problem->run(boundaryValue); 
+                            std::shared_ptr<SolutionMesh> mesh = problem->solution_mesh();
+                            return [this, statistics, mesh] { takeOverResult(statistics, mesh); };
+                        },
+                        "Same Grid reused.");
         }
         else
         {
@@ -376,13 +540,49 @@ public:
             _refinement = refinement->currentText().toInt();
             _shapeFunction = shapeFunction->currentText().toInt();
             _boundaryCondition = boundaryCondition->currentText();
+            _preconditioner = preconditioner->currentText();
 
             if (_boundaryCondition == "Constant")
             { _boundaryValue = boundaryValue->text().toInt(); }
 
-            poissonProblem2D = new Poisson<2>(_dimensions2D, _refinement, _shapeFunction, _boundaryValue, boundaryIsConstant);
-            poissonProblem2D->run();
-            visualizationWidget->openFile("solution-2d.vtk", "New Grid generated.");
+            std::vector<int> dimensions = _dimensions2D;
+            int refinementLevel = _refinement, shapeFunctionOrder = _shapeFunction, boundaryValue = _boundaryValue;
+            bool homogeneous = boundaryIsConstant;
+            SolverOptions options = selectedSolverOptions();
+            ProblemKey key = {"2D Square Grid", {dimensions.begin(), dimensions.end()}, refinementLevel, shapeFunctionOrder, _preconditioner};
+            std::shared_ptr<Poisson<2>> cachedProblem = problemCache.find<Poisson<2>>(key);
+            if (cachedProblem)
+            {
+                startSolver([this, cachedProblem, homogeneous, boundaryValue]
+                            {
+                                cachedProblem->set_homogeneous(homogeneous);
+                                SolveStatistics statistics = cachedProblem->run(boundaryValue);
+                                std::shared_ptr<SolutionMesh> mesh = cachedProblem->solution_mesh();
+                                return [this, cachedProblem, statistics, mesh] 
+                                       { 
+                                           poissonProblem2D = cachedProblem;
+                                           takeOverResult(statistics, mesh); 
+                                       };
+                            },
+                            "Cached Grid reused.");
+                return;
+            }
+
+            startSolver([=] 
+                        {
+                            auto problem = std::make_shared<Poisson<2>>(dimensions, refinementLevel, shapeFunctionOrder, 
+                                                                        boundaryValue, homogeneous, options);
+                            SolveStatistics statistics = problem->run();
+                            std::shared_ptr<SolutionMesh> mesh = problem->solution_mesh();
+                            return [this, key, problem, statistics, mesh] 
+                                   { 
+                                       poissonProblem2D = problem;
+                                       problemCache.insert(key, problem);
+                                       releaseEvictedProblems();
+                                       takeOverResult(statistics, mesh); 
+                                   };
+                        },
+                        "New Grid generated.");
         }
     }
 
@@ -392,9 +592,10 @@ public:
      *  The function checks if the mesh can be reused or if the program has to generate
      *  a new mesh. If only the boundary value has changed, the same mesh is used again for
      *  the new calculation. If this is not the case, all input parameters are read into the 
-     *  respective variables and a new instance of the Poisson class is initialized. This 
-     *  class is then used to solve the Poisson equation on the 3D square grid. The solution 
-     *  is visualized by the visualization widget.
+     *  respective variables. A Poisson object with the same grid is taken from the cache of
+     *  recently solved problems, otherwise a new instance of the Poisson class is initialized
+     *  and added to the cache. This class is then used to solve the Poisson equation on the 
+     *  3D square grid. The solution is visualized by the visualization widget.
      */
     void solve3DsquareGrid()
     {
@@ -403,8 +604,15 @@ public:
             if (boundaryValueNotChanged()) { return; }
             _boundaryValue = boundaryValue->text().toInt();
 
-            poissonProblem3D->run(_boundaryValue);
-            visualizationWidget->openFile("solution-3d.vtk", "Same Grid reused.");
+            int boundaryValue = _boundaryValue;
+            std::shared_ptr<Poisson<3>> problem = poissonProblem3D;
+            startSolver([this, problem, boundaryValue] 
+                        { 
+                            SolveStatistics statistics = problem->run(boundaryValue); 
+                            std::shared_ptr<SolutionMesh> mesh = problem->solution_mesh();
+                            return [this, statistics, mesh] { takeOverResult(statistics, mesh); };
+                        },
+                        "Same Grid reused.");
         }
         else
         {
@@ -414,13 +622,49 @@ public:
             _refinement = refinement->currentText().toInt();
             _shapeFunction = shapeFunction->currentText().toInt();
             _boundaryCondition = boundaryCondition->currentText();
+            _preconditioner = preconditioner->currentText();
             
             if (_boundaryCondition == "Constant")
             { _boundaryValue = boundaryValue->text().toInt(); }
 
-            poissonProblem3D = new Poisson<3>(_dimensions3D, _refinement, _shapeFunction, _boundaryValue, boundaryIsConstant);
-            poissonProblem3D->run();
-            visualizationWidget->openFile("solution-3d.vtk", "New Grid generated.");
+            std::vector<int> dimensions = _dimensions3D;
+            int refinementLevel = _refinement, shapeFunctionOrder = _shapeFunction, boundaryValue = _boundaryValue;
+            bool homogeneous = boundaryIsConstant;
+            SolverOptions options = selectedSolverOptions();
+            ProblemKey key = {"3D Square Grid", {dimensions.begin(), dimensions.end()}, refinementLevel, shapeFunctionOrder, _preconditioner};
+            std::shared_ptr<Poisson<3>> cachedProblem = problemCache.find<Poisson<3>>(key);
+            if (cachedProblem)
+            {
+                startSolver([this, cachedProblem, homogeneous, boundaryValue]
+                            {
+                                cachedProblem->set_homogeneous(homogeneous);
+                                SolveStatistics statistics = cachedProblem->run(boundaryValue);
+                                std::shared_ptr<SolutionMesh> mesh = cachedProblem->solution_mesh();
+                                return [this, cachedProblem, statistics, mesh] 
+                                       { 
+                                           poissonProblem3D = cachedProblem;
+                                           takeOverResult(statistics, mesh); 
+                                       };
+                            },
+                            "Cached Grid reused.");
+                return;
+            }
+
+            startSolver([=] 
+                        {
+                            auto problem = std::make_shared<Poisson<3>>(dimensions, refinementLevel, shapeFunctionOrder, 
+                                                                        boundaryValue, homogeneous, options);
+                            SolveStatistics statistics = problem->run();
+                            std::shared_ptr<SolutionMesh> mesh = problem->solution_mesh();
+                            return [this, key, problem, statistics, mesh] 
+                                   { 
+                                       poissonProblem3D = problem;
+                                       problemCache.insert(key, problem);
+                                       releaseEvictedProblems();
+                                       takeOverResult(statistics, mesh); 
+                                   };
+                        },
+                        "New Grid generated.");
         }
     }
 
@@ -430,9 +674,10 @@ public:
      *  The function checks if the mesh can be reused or if the program has to generate
      *  a new mesh. If only the boundary value has changed, the same mesh is used again for
      *  the new calculation. If this is not the case, all input parameters are read into the 
-     *  respective variables and a new instance of the Poisson class is initialized. This 
-     *  class is then used to solve the Poisson equation on the radial grid. The solution 
-     *  is visualized by the visualization widget.
+     *  respective variables. A Poisson object with the same grid is taken from the cache of
+     *  recently solved problems, otherwise a new instance of the Poisson class is initialized
+     *  and added to the cache. This class is then used to solve the Poisson equation on the 
+     *  radial grid. The solution is visualized by the visualization widget.
      */
     void solveRadialGrid()
     {
@@ -441,8 +686,15 @@ public:
             if (boundaryValueNotChanged()) { return; }
             _boundaryValue = boundaryValue->text().toInt();
         
-            poissonProblemRad->run(_boundaryValue);
-            visualizationWidget->openFile("solution-2d.vtk", "Same Grid reused.");
+            int boundaryValue = _boundaryValue;
+            std::shared_ptr<Radial_Poisson> problem = poissonProblemRad;
+            startSolver([this, problem, boundaryValue] 
+                        { 
+                            SolveStatistics statistics = problem->run(boundaryValue); 
+                            std::shared_ptr<SolutionMesh> mesh = problem->solution_mesh();
+                            return [this, statistics, mesh] { takeOverResult(statistics, mesh); };
+                        },
+                        "Same Grid reused.");
         }
         else
         {
@@ -451,13 +703,47 @@ public:
             _refinement = refinement->currentText().toInt();
             _shapeFunction = shapeFunction->currentText().toInt();
             _boundaryCondition = boundaryCondition->currentText();
+            _preconditioner = preconditioner->currentText();
             
             if (_boundaryCondition == "Constant")
             { _boundaryValue = boundaryValue->text().toInt(); }
 
-            poissonProblemRad = new Radial_Poisson(_dimensionsRad, _refinement, _shapeFunction, _boundaryValue);
-            poissonProblemRad->run();
-            visualizationWidget->openFile("solution-2d.vtk", "New Grid generated.");
+            std::vector<double> dimensions = _dimensionsRad;
+            int refinementLevel = _refinement, shapeFunctionOrder = _shapeFunction, boundaryValue = _boundaryValue;
+            SolverOptions options = selectedSolverOptions();
+            ProblemKey key = {"Radial Grid", {dimensions.begin(), dimensions.end()}, refinementLevel, shapeFunctionOrder, _preconditioner};
+            std::shared_ptr<Radial_Poisson> cachedProblem = problemCache.find<Radial_Poisson>(key);
+            if (cachedProblem)
+            {
+                startSolver([this, cachedProblem, boundaryValue]
+                            {
+                                SolveStatistics statistics = cachedProblem->run(boundaryValue);
+                                std::shared_ptr<SolutionMesh> mesh = cachedProblem->solution_mesh();
+                                return [this, cachedProblem, statistics, mesh] 
+                                       { 
+                                           poissonProblemRad = cachedProblem;
+                                           takeOverResult(statistics, mesh); 
+                                       };
+                            },
+                            "Cached Grid reused.");
+                return;
+            }
+
+            startSolver([=] 
+                        {
+                            auto problem = std::make_shared<Radial_Poisson>(dimensions, refinementLevel, shapeFunctionOrder, 
+                                                                            boundaryValue, options);
+                            SolveStatistics statistics = problem->run();
+                            std::shared_ptr<SolutionMesh> mesh = problem->solution_mesh();
+                            return [this, key, problem, statistics, mesh] 
+                                   { 
+                                       poissonProblemRad = problem;
+                                       problemCache.insert(key, problem);
+                                       releaseEvictedProblems();
+                                       takeOverResult(statistics, mesh); 
+                                   };
+                        },
+                        "New Grid generated.");
         }
     }
 
@@ -529,8 +815,8 @@ public slots:
      * 
      *  If the run button is clicked, the function is checking if all input parameters 
      *  are valid. If this is the case, the Poisson equation is solved on the selected
-     *  mesh with the help of the Poisson library. The solution is then visualized by
-     *  the visualization widget.
+     *  mesh with the help of the Poisson library on the worker thread. The solution is 
+     *  visualized by the visualization widget when the solver has finished.
      */
     void clickedRunButton()
     {
@@ -549,4 +835,79 @@ public slots:
             solveRadialGrid();
         }
     }
+
+    /**
+     *  @brief Function that cancels the running Poisson solver if the cancel button is clicked.
+     */
+    void clickedCancelButton()
+    {
+        cancelButton->setEnabled(false);
+        statusBar()->showMessage("Cancelling...");
+        solverThread->cancel();
+    }
+
+    /**
+     *  @brief Function that shows the progress of the Poisson solver in the status bar.
+     * 
+     *  @param phase Phase of the solver, see SolvePhase.
+     *  @param step Number of the CG iteration in the solve phase.
+     */
+    void updateProgress(int phase, int step)
+    {
+        switch (static_cast<SolvePhase>(phase))
+        {
+            case SolvePhase::grid:     statusBar()->showMessage("Generating grid..."); break;
+            case SolvePhase::dofs:     statusBar()->showMessage("Distributing degrees of freedom..."); break;
+            case SolvePhase::assembly: statusBar()->showMessage("Assembling system..."); break;
+            case SolvePhase::solve:    statusBar()->showMessage(QString("CG iteration %1").arg(step)); break;
+            case SolvePhase::output:   statusBar()->showMessage("Writing output..."); break;
+        }
+    }
+
+    /**
+     *  @brief Function that visualizes the solution when the Poisson solver has finished.
+     * 
+     *  The size of the problem and the timing of the solver are shown in the status bar.
+     */
+    void finishedSolve()
+    {
+        const QString iterations = resultStatistics.warm_start
+                                       ? QString("%1 (warm start saved %2)").arg(resultStatistics.cg_iterations)
+                                                                            .arg(resultStatistics.saved_cg_iterations)
+                                       : QString::number(resultStatistics.cg_iterations);
+        stoppedSolver(QString("Poisson Problem solved: %1 DoFs, %2 CG iterations, residual %3, "
+                              "assembly %4 s, solve %5 s, total %6 s, peak memory %7 MB.")
+                          .arg(resultStatistics.n_dofs)
+                          .arg(iterations)
+                          .arg(resultStatistics.residual, 0, 'g', 3)
+                          .arg(resultStatistics.assembly_time, 0, 'f', 3)
+                          .arg(resultStatistics.solve_time, 0, 'f', 3)
+                          .arg(resultStatistics.total_time(), 0, 'f', 3)
+                          .arg(resultStatistics.peak_memory / 1024));
+        visualizationWidget->showSolution(resultMesh, resultDescription);
+    }
+
+    /**
+     *  @brief Function that resets the GUI when the Poisson solver was cancelled.
+     * 
+     *  The saved refinement level is reset, so the next calculation generates a new
+     *  grid instead of reusing the partially solved Poisson object.
+     */
+    void cancelledSolve()
+    {
+        _refinement = 0;
+        stoppedSolver("Poisson Problem cancelled.");
+    }
+
+    /**
+     *  @brief Function that shows an error message when the Poisson solver has failed.
+     * 
+     *  @param message Message of the exception thrown by the Poisson solver.
+     */
+    void failedSolve(const QString& message)
+    {
+        _refinement = 0;
+        stoppedSolver("Poisson Problem failed.");
+        QMessageBox::information(this, "Error", message);
+    }
 }; 